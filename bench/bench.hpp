@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A small harness to compare each adaptor with the loop one would write by hand.
+//
+// suite.compare(name, type, size, adaptor, hand) times the two functions, which must compute the same
+// value over size elements, and records the time per element of each. Every measurement is the best of
+// several samples, taken in turns for the adaptor and the hand loop so that both see the same machine, and
+// each sample repeats the function until it lasts long enough to time.
+//
+// The comparisons are printed as a table to stderr, and suite.report() writes them as JSON to the file
+// given by --json=<path>, or else to stdout. A comparison whose adaptor is more than --threshold (10% by default) slower than the hand loop
+// is flagged. --filter=<text> only runs the comparisons whose name contains the text, and
+// --min-time=<ms> sets the length of a sample.
+
+namespace bench
+{
+    /// \brief Keep the compiler from optimising away the computation of value.
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile(""
+                     :
+                     : "r,m"(value)
+                     : "memory");
+#else
+        static const void *volatile sink;
+        sink = &value;
+#endif
+    }
+
+    struct result
+    {
+        std::string name;
+        std::string type;
+        std::size_t size;
+        double adaptor_ns;
+        double hand_ns;
+
+        double overhead() const
+        {
+            return adaptor_ns / hand_ns - 1;
+        }
+    };
+
+    class suite
+    {
+    public:
+        suite(int argc, char **argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg = argv[i];
+                if (starts_with(arg, "--json="))
+                {
+                    _M_json = arg.substr(7);
+                }
+                else if (starts_with(arg, "--filter="))
+                {
+                    _M_filter = arg.substr(9);
+                }
+                else if (starts_with(arg, "--threshold="))
+                {
+                    _M_threshold = std::stod(arg.substr(12));
+                }
+                else if (starts_with(arg, "--min-time="))
+                {
+                    _M_min_time = std::stod(arg.substr(11)) * 1e-3;
+                }
+                else
+                {
+                    std::cerr << "usage: " << argv[0] << " [--json=<path>] [--filter=<text>] [--threshold=<ratio>] [--min-time=<ms>]" << std::endl;
+                    std::exit(2);
+                }
+            }
+        }
+
+        /// \brief Time adaptor() against hand(), which both compute the same value over size elements.
+        template <typename Adaptor, typename Hand>
+        void compare(const std::string &name, const std::string &type, std::size_t size, Adaptor adaptor, Hand hand)
+        {
+            if (name.find(_M_filter) == std::string::npos)
+            {
+                return;
+            }
+            if (!(adaptor() == hand()))
+            {
+                std::cerr << name << "/" << type << "/" << size << ": the adaptor and the hand loop disagree" << std::endl;
+                _M_failed = true;
+                return;
+            }
+            std::size_t adaptor_reps = repetitions(adaptor), hand_reps = repetitions(hand);
+            double adaptor_best = 1e300, hand_best = 1e300;
+            for (int sample = 0; sample < _M_samples; ++sample)
+            {
+                adaptor_best = std::min(adaptor_best, seconds(adaptor, adaptor_reps) / adaptor_reps);
+                hand_best = std::min(hand_best, seconds(hand, hand_reps) / hand_reps);
+            }
+            double elements = static_cast<double>(std::max<std::size_t>(size, 1));
+            _M_results.push_back({name, type, size, adaptor_best * 1e9 / elements, hand_best * 1e9 / elements});
+            const result &r = _M_results.back();
+            std::fprintf(stderr, "%-16s %-8s %10zu %12.3f %12.3f %+8.1f%%%s\n", name.c_str(), type.c_str(), size, r.adaptor_ns, r.hand_ns,
+                        100 * r.overhead(), flagged(r) ? "  OVERHEAD" : "");
+        }
+
+        /// \brief Print the flagged comparisons and write the JSON; returns the exit code of the program.
+        int report() const
+        {
+            std::size_t flags = 0;
+            for (const result &r : _M_results)
+            {
+                if (flagged(r))
+                {
+                    std::cerr << "abstraction overhead above " << 100 * _M_threshold << "%: " << r.name << "/" << r.type << "/" << r.size
+                              << " " << 100 * r.overhead() << "%" << std::endl;
+                    ++flags;
+                }
+            }
+            std::cerr << flags << " of " << _M_results.size() << " comparisons flagged" << std::endl;
+
+            std::string json = to_json();
+            if (_M_json.empty())
+            {
+                std::cout << json;
+            }
+            else
+            {
+                std::ofstream(_M_json) << json;
+            }
+            return _M_failed ? 1 : 0;
+        }
+
+        void header() const
+        {
+            std::fprintf(stderr, "%-16s %-8s %10s %12s %12s %9s\n", "adaptor", "type", "size", "adaptor ns", "hand ns", "overhead");
+        }
+
+    private:
+        static bool starts_with(const std::string &s, const char *prefix)
+        {
+            return s.compare(0, std::strlen(prefix), prefix) == 0;
+        }
+
+        bool flagged(const result &r) const
+        {
+            return r.overhead() > _M_threshold;
+        }
+
+        template <typename Fn>
+        static double seconds(Fn &fn, std::size_t reps)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < reps; ++i)
+            {
+                do_not_optimize(fn());
+            }
+            auto stop = std::chrono::steady_clock::now();
+            return std::chrono::duration<double>(stop - start).count();
+        }
+
+        /// \brief How many calls make a sample last at least the minimum time.
+        template <typename Fn>
+        std::size_t repetitions(Fn &fn) const
+        {
+            std::size_t reps = 1;
+            for (;;)
+            {
+                double s = seconds(fn, reps);
+                if (s >= _M_min_time || reps >= (std::size_t(1) << 30))
+                {
+                    return reps;
+                }
+                reps = s <= 0 ? reps * 16 : std::max(reps * 2, static_cast<std::size_t>(reps * 1.2 * _M_min_time / s));
+            }
+        }
+
+        std::string to_json() const
+        {
+            std::ostringstream out;
+            out << "{\n  \"threshold\": " << _M_threshold << ",\n  \"benchmarks\": [";
+            for (std::size_t i = 0; i < _M_results.size(); ++i)
+            {
+                const result &r = _M_results[i];
+                out << (i ? ",\n" : "\n")
+                    << "    {\"name\": \"" << r.name << "/" << r.type << "/" << r.size << "\", \"adaptor\": \"" << r.name
+                    << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size
+                    << ", \"adaptor_ns_per_element\": " << r.adaptor_ns << ", \"hand_ns_per_element\": " << r.hand_ns
+                    << ", \"overhead\": " << r.overhead() << ", \"flagged\": " << (flagged(r) ? "true" : "false") << "}";
+            }
+            out << "\n  ]\n}\n";
+            return out.str();
+        }
+
+        std::vector<result> _M_results;
+        std::string _M_json;
+        std::string _M_filter;
+        double _M_threshold = 0.10;
+        double _M_min_time = 0.005;
+        int _M_samples = 5;
+        bool _M_failed = false;
+    };
+
+} // namespace bench
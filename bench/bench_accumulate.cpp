@@ -0,0 +1,66 @@
+#include <itertools/accumulate.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Running sums of 2^25 integers: the lazy view, accumulate_into on one thread (SSE2 for integers),
+// and accumulate_into with the parallel blocked scan, for each number of threads.
+
+template <typename Run>
+double seconds(Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+template <typename T>
+void bench(const char *name)
+{
+    std::size_t n = std::size_t(1) << 25;
+    std::vector<T> nums(n), sums(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        nums[i] = static_cast<T>(i * 2654435761u % 1000);
+    }
+
+    double lazy = seconds([&] {
+        auto out = sums.begin();
+        for (auto s : itertools::accumulate(nums, T(0)))
+        {
+            *out++ = s;
+        }
+    });
+    std::cout << name << " lazy seconds=" << lazy << " (last " << sums.back() << ")" << std::endl;
+
+    double seq = seconds([&] { itertools::accumulate_into(nums.begin(), nums.end(), sums.begin(), T(0)); });
+    std::cout << name << " seq seconds=" << seq << " speedup=" << lazy / seq << " (last " << sums.back() << ")" << std::endl;
+
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        itertools::parallel::thread_pool pool(threads);
+        double par = seconds([&] {
+            itertools::accumulate_into(nums.begin(), nums.end(), sums.begin(), T(0), std::plus<>(), itertools::parallel::par.on(pool));
+        });
+        std::cout << name << " par threads=" << threads << " seconds=" << par << " speedup=" << lazy / par
+                  << " (last " << sums.back() << ")" << std::endl;
+        if (threads == max_threads)
+        {
+            break;
+        }
+    }
+}
+
+int main()
+{
+    bench<std::int32_t>("int32");
+    bench<std::int64_t>("int64");
+    bench<double>("double");
+
+    return 0;
+}
@@ -0,0 +1,369 @@
+#include "bench.hpp"
+
+#include <itertools/accumulate.hpp>
+#include <itertools/chain.hpp>
+#include <itertools/combinations.hpp>
+#include <itertools/compress.hpp>
+#include <itertools/count.hpp>
+#include <itertools/cycle.hpp>
+#include <itertools/filter.hpp>
+#include <itertools/groupby.hpp>
+#include <itertools/islice.hpp>
+#include <itertools/product.hpp>
+#include <itertools/starmap.hpp>
+#include <itertools/takewhile.hpp>
+#include <itertools/zip.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Every adaptor against the loop that does the same by hand, for int and double elements and several
+// sizes. Each pair reduces to the same value, which the harness checks before timing them. Run
+//
+//     bench_adaptors [--json=<path>] [--filter=<adaptor>] [--threshold=<ratio>] [--min-time=<ms>]
+//
+// or build the bench target, which writes bench_adaptors.json in the build directory. Comparisons whose
+// adaptor is more than 10% slower than the hand loop are flagged.
+
+template <typename T>
+using acc_t = std::conditional_t<std::is_integral_v<T>, long long, double>;
+
+template <typename T>
+std::vector<T> make_data(std::size_t n, std::uint32_t seed)
+{
+    std::vector<T> data(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        data[i] = static_cast<T>((i * 2654435761u + seed) % 1000);
+    }
+    return data;
+}
+
+template <typename T>
+void bench_type(bench::suite &suite, const std::string &type, std::size_t n)
+{
+    std::vector<T> a = make_data<T>(n, 1), b = make_data<T>(n, 7);
+    auto small = [](T x) { return x < T(500); };
+
+    suite.compare(
+        "zip", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [x, y] : itertools::zip(a, b))
+            {
+                s += x * y;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s += a[i] * b[i];
+            }
+            return s;
+        });
+
+    suite.compare(
+        "zip(count)", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [i, x] : itertools::zip(itertools::count(std::size_t(0), std::size_t(1)), a))
+            {
+                s += static_cast<acc_t<T>>(i) * x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s += static_cast<acc_t<T>>(i) * a[i];
+            }
+            return s;
+        });
+
+    std::size_t m = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+    std::vector<T> rows(a.begin(), a.begin() + m), cols(b.begin(), b.begin() + m);
+    suite.compare(
+        "product", type, m * m,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [x, y] : itertools::product(rows, cols))
+            {
+                s += x * y;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t j = 0; j < m; ++j)
+                {
+                    s += rows[i] * cols[j];
+                }
+            }
+            return s;
+        });
+
+    std::size_t k = static_cast<std::size_t>(std::sqrt(2.0 * n));
+    std::vector<T> items(a.begin(), a.begin() + k);
+    suite.compare(
+        "combinations", type, k * (k - 1) / 2,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [x, y] : itertools::combinations<2>(items))
+            {
+                s += x * y;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < k; ++i)
+            {
+                for (std::size_t j = i + 1; j < k; ++j)
+                {
+                    s += items[i] * items[j];
+                }
+            }
+            return s;
+        });
+
+    suite.compare(
+        "filter", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::filter(small, a))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (small(a[i]))
+                {
+                    s += a[i];
+                }
+            }
+            return s;
+        });
+
+    suite.compare(
+        "filter_blocked", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::filter_blocked(small, a))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (small(a[i]))
+                {
+                    s += a[i];
+                }
+            }
+            return s;
+        });
+
+    std::vector<std::uint8_t> selectors(n);
+    std::transform(b.begin(), b.end(), selectors.begin(), small);
+    suite.compare(
+        "compress", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::compress(a, selectors))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (selectors[i])
+                {
+                    s += a[i];
+                }
+            }
+            return s;
+        });
+
+    suite.compare(
+        "starmap", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::starmap([](T x, T y) { return x * y + x; }, itertools::zip(a, b)))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s += a[i] * b[i] + a[i];
+            }
+            return s;
+        });
+
+    suite.compare(
+        "accumulate", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::accumulate(a, acc_t<T>(0)))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0, running = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                running += a[i];
+                s += running;
+            }
+            return s;
+        });
+
+    suite.compare(
+        "chain", type, 2 * n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::chain(a, b))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s += a[i];
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s += b[i];
+            }
+            return s;
+        });
+
+    suite.compare(
+        "islice", type, n / 3,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::islice(a, std::ptrdiff_t(1), static_cast<std::ptrdiff_t>(n), 3))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 1; i < n; i += 3)
+            {
+                s += a[i];
+            }
+            return s;
+        });
+
+    suite.compare(
+        "takewhile", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto x : itertools::takewhile([](T x) { return x >= T(0); }, a))
+            {
+                s += x;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n && a[i] >= T(0); ++i)
+            {
+                s += a[i];
+            }
+            return s;
+        });
+
+    std::vector<T> period(a.begin(), a.begin() + std::min<std::size_t>(n, 64));
+    suite.compare(
+        "cycle", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [x, y] : itertools::zip(a, itertools::cycle(period)))
+            {
+                s += x * y;
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0, j = 0; i < n; ++i)
+            {
+                s += a[i] * period[j];
+                if (++j == period.size())
+                {
+                    j = 0;
+                }
+            }
+            return s;
+        });
+
+    std::vector<T> sorted = a;
+    std::sort(sorted.begin(), sorted.end());
+    suite.compare(
+        "groupby", type, n,
+        [&] {
+            acc_t<T> s = 0;
+            for (auto [key, group] : itertools::groupby(sorted))
+            {
+                s += key * static_cast<acc_t<T>>(group.size());
+            }
+            return s;
+        },
+        [&] {
+            acc_t<T> s = 0;
+            for (std::size_t i = 0; i < n;)
+            {
+                std::size_t j = i + 1;
+                while (j < n && sorted[j] == sorted[i])
+                {
+                    ++j;
+                }
+                s += sorted[i] * static_cast<acc_t<T>>(j - i);
+                i = j;
+            }
+            return s;
+        });
+}
+
+int main(int argc, char **argv)
+{
+    bench::suite suite(argc, argv);
+    suite.header();
+    for (std::size_t n : {std::size_t(1) << 10, std::size_t(1) << 14, std::size_t(1) << 20})
+    {
+        bench_type<int>(suite, "int", n);
+        bench_type<double>(suite, "double", n);
+    }
+    return suite.report();
+}
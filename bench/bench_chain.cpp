@@ -0,0 +1,76 @@
+#include <itertools/chain.hpp>
+#include <itertools/segmented.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Sum of 2^25 integers in 32 vectors chained together: a loop over a single vector of all of them,
+// a range-for over the chain, and itertools::for_each over the chain, which loops over each vector in turn;
+// then the same with chain_from_iterable over the vector of the 32 vectors.
+
+template <typename Run>
+double seconds(Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+int main()
+{
+    constexpr std::size_t shards = 32;
+    std::size_t n = (std::size_t(1) << 25) / shards;
+    std::vector<std::vector<std::int64_t>> v(shards, std::vector<std::int64_t>(n));
+    std::vector<std::int64_t> flat;
+    for (std::size_t s = 0; s < shards; ++s)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v[s][i] = static_cast<std::int64_t>((s * n + i) * 2654435761u % 1000);
+        }
+        flat.insert(flat.end(), v[s].begin(), v[s].end());
+    }
+    auto chained = itertools::chain(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13], v[14], v[15],
+                                    v[16], v[17], v[18], v[19], v[20], v[21], v[22], v[23], v[24], v[25], v[26], v[27], v[28], v[29], v[30], v[31]);
+
+    std::int64_t sum = 0;
+    double plain = seconds([&] {
+        for (auto x : flat)
+        {
+            sum += x;
+        }
+    });
+    std::cout << "vector seconds=" << plain << " (sum " << sum << ")" << std::endl;
+
+    sum = 0;
+    double iterated = seconds([&] {
+        for (auto x : chained)
+        {
+            sum += x;
+        }
+    });
+    std::cout << "chain range-for seconds=" << iterated << " (sum " << sum << ")" << std::endl;
+
+    sum = 0;
+    double segmented = seconds([&] { itertools::for_each(chained, [&sum](std::int64_t x) { sum += x; }); });
+    std::cout << "chain for_each seconds=" << segmented << " speedup=" << iterated / segmented << " (sum " << sum << ")" << std::endl;
+
+    auto flattened = itertools::chain_from_iterable(v);
+    sum = 0;
+    iterated = seconds([&] {
+        for (auto x : flattened)
+        {
+            sum += x;
+        }
+    });
+    std::cout << "chain_from_iterable range-for seconds=" << iterated << " (sum " << sum << ")" << std::endl;
+
+    sum = 0;
+    segmented = seconds([&] { itertools::for_each(flattened, [&sum](std::int64_t x) { sum += x; }); });
+    std::cout << "chain_from_iterable for_each seconds=" << segmented << " speedup=" << iterated / segmented << " (sum " << sum << ")" << std::endl;
+
+    return 0;
+}
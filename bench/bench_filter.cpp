@@ -0,0 +1,66 @@
+#include <itertools/compress.hpp>
+#include <itertools/filter.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// filter and compress over 2^24 elements, one element at a time and in blocks of 64 through a bitmask
+// (filter against filter_blocked), for several selectivities, and compress over a std::vector<bool> mask,
+// one bit at a time and by searching the packed words. The bitmask iterators should win most when few
+// elements are selected.
+
+template <typename View>
+double seconds(View &&view, long long &sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    sum = 0;
+    for (auto x : view)
+    {
+        sum += x;
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+int main()
+{
+    std::size_t n = std::size_t(1) << 24;
+    std::vector<int> data(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        data[i] = static_cast<int>(i * 2654435761u % 1000);
+    }
+
+    for (int percent : {1, 10, 50})
+    {
+        auto pred = [percent](int x) { return x < percent * 10; };
+        long long plain_sum, blocked_sum;
+        double plain = seconds(itertools::filter(pred, data), plain_sum);
+        double blocked = seconds(itertools::filter_blocked(pred, data), blocked_sum);
+        std::cout << "filter selected=" << percent << "% plain=" << plain << " blocked=" << blocked
+                  << " speedup=" << plain / blocked << " (sums " << plain_sum << " " << blocked_sum << ")" << std::endl;
+
+        std::vector<std::uint8_t> selectors(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            selectors[i] = pred(data[i]);
+        }
+        using plain_compress_t = itertools::compress_iterator<std::vector<int>::iterator, std::vector<std::uint8_t>::iterator>;
+        plain = seconds(itertools::range_view<plain_compress_t>(plain_compress_t(data.begin(), data.end(), selectors.begin(), selectors.end()),
+                                                                plain_compress_t(data.end(), data.end(), selectors.end(), selectors.end())),
+                        plain_sum);
+        blocked = seconds(itertools::compress(data, selectors), blocked_sum);
+        std::cout << "compress selected=" << percent << "% plain=" << plain << " blocked=" << blocked
+                  << " speedup=" << plain / blocked << " (sums " << plain_sum << " " << blocked_sum << ")" << std::endl;
+
+        std::vector<bool> bits(selectors.begin(), selectors.end());
+        plain = seconds(itertools::compress(data.begin(), data.end(), bits.begin(), bits.end()), plain_sum);
+        blocked = seconds(itertools::compress(data, bits), blocked_sum);
+        std::cout << "compress vector<bool> selected=" << percent << "% plain=" << plain << " packed=" << blocked
+                  << " speedup=" << plain / blocked << " (sums " << plain_sum << " " << blocked_sum << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <itertools/groupby.hpp>
+#include <itertools/groupby_hash.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Sums by key of 2^24 integers with 2^16 distinct keys: sorting then groupby, groupby_hash on one thread,
+// and groupby_hash with per-thread tables, for each number of threads.
+
+template <typename Run>
+double seconds(Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+int main()
+{
+    std::size_t n = std::size_t(1) << 24;
+    std::vector<std::uint32_t> nums(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        nums[i] = static_cast<std::uint32_t>(i * 2654435761u);
+    }
+    auto key = [](std::uint32_t x) { return x >> 16; };
+
+    std::int64_t check = 0;
+    double sorted = seconds([&] {
+        std::vector<std::uint32_t> copy = nums;
+        std::sort(copy.begin(), copy.end(), [&](std::uint32_t a, std::uint32_t b) { return key(a) < key(b); });
+        for (auto [k, g] : itertools::groupby(copy, key))
+        {
+            std::int64_t sum = 0;
+            for (auto x : g)
+            {
+                sum += x;
+            }
+            check += sum ^ k;
+        }
+    });
+    std::cout << "sort+groupby seconds=" << sorted << " (check " << check << ")" << std::endl;
+
+    std::size_t groups = 0;
+    double seq = seconds([&] { groups = itertools::groupby_hash(nums, key, std::int64_t(0), std::plus<>()).size(); });
+    std::cout << "groupby_hash seq seconds=" << seq << " speedup=" << sorted / seq << " (groups " << groups << ")" << std::endl;
+
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        itertools::parallel::thread_pool pool(threads);
+        double par = seconds([&] {
+            groups = itertools::groupby_hash(nums, key, std::int64_t(0), std::plus<>(), std::plus<>(), itertools::parallel::par.on(pool)).size();
+        });
+        std::cout << "groupby_hash par threads=" << threads << " seconds=" << par << " speedup=" << sorted / par
+                  << " (groups " << groups << ")" << std::endl;
+        if (threads == max_threads)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+
+#include <itertools/combinations.hpp>
+#include <itertools/parallel.hpp>
+#include <itertools/product.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+// Scaling of parallel::transform_reduce over product and combinations<4> with the number of threads.
+// Each element costs a few ns of integer work, so the runs measure the overhead of cutting the views
+// and of the pool. Speedup should be close to the number of threads, up to the number of cores.
+
+std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+template <typename View, typename Transform>
+double run(std::size_t threads, View &&view, Transform transform, std::uint64_t &checksum)
+{
+    itertools::parallel::thread_pool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    checksum = itertools::parallel::transform_reduce(
+        pool, view, std::uint64_t(0), [](std::uint64_t a, std::uint64_t b) { return a ^ b; }, transform);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+template <typename View, typename Transform>
+void bench(const char *name, View &&view, Transform transform)
+{
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    double base = 0;
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        std::uint64_t checksum;
+        double seconds = run(threads, view, transform, checksum);
+        if (threads == 1)
+        {
+            base = seconds;
+        }
+        std::cout << name << " threads=" << threads
+                  << " elements=" << view.size()
+                  << " seconds=" << seconds
+                  << " speedup=" << base / seconds
+                  << " (checksum " << checksum << ")" << std::endl;
+        if (threads == max_threads)
+        {
+            break;
+        }
+    }
+}
+
+int main()
+{
+    std::vector<std::uint64_t> items(200);
+    std::iota(items.begin(), items.end(), 1);
+    std::vector<std::uint64_t> few(8);
+    std::iota(few.begin(), few.end(), 1);
+
+    // 200 * 200 * 200 * 8 = 64,000,000 tuples, about as many as C(200, 4) = 64,684,950
+    bench("product", itertools::product(items, items, items, few), [](auto &&t) {
+        auto [a, b, c, d] = t;
+        return mix(a * 1000003 + b * 10007 + c * 101 + d);
+    });
+
+    bench("combinations<4>", itertools::combinations<4>(items), [](auto &&t) {
+        auto [a, b, c, d] = t;
+        return mix(a * 1000003 + b * 10007 + c * 101 + d);
+    });
+
+    return 0;
+}
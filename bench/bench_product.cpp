@@ -0,0 +1,63 @@
+
+#include <itertools/product.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Size and per-step cost of product_iterator as the number of dimensions grows.
+// Both should grow linearly with D.
+
+template <std::size_t D, std::size_t... I>
+auto make_product(const std::array<std::vector<int>, D> &dims, std::index_sequence<I...>)
+{
+    return itertools::product(dims[I]...);
+}
+
+template <std::size_t D>
+void bench_product(std::size_t radix)
+{
+    std::array<std::vector<int>, D> dims;
+    for (auto &dim : dims)
+    {
+        for (std::size_t i = 0; i != radix; ++i)
+        {
+            dim.push_back(static_cast<int>(i));
+        }
+    }
+    auto p = make_product<D>(dims, std::make_index_sequence<D>());
+
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    std::size_t steps = 0;
+    for (auto it = p.begin(), last = p.end(); it != last; ++it, ++steps)
+    {
+        sum += std::get<D - 1>(*it);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+    std::cout << "D=" << D
+              << " sizeof=" << sizeof(p.begin())
+              << " sizeof/D=" << sizeof(p.begin()) / D
+              << " steps=" << steps
+              << " ns/step=" << ns / steps
+              << " (checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+    bench_product<1>(1 << 20);
+    bench_product<2>(1 << 10);
+    bench_product<3>(101);
+    bench_product<4>(32);
+    bench_product<5>(16);
+    bench_product<6>(10);
+    bench_product<7>(7);
+    bench_product<8>(6);
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <itertools/count.hpp>
+#include <itertools/repeat.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/takewhile.hpp>
+#include <itertools/zip.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Views that end with a sentinel, against the same views wrapped by common(), whose end is an iterator as
+// the views had before, and against hand-written loops, over 2^24 elements. Also prints the sizes of the
+// iterators and of the ends: the sentinels should make both smaller, and the loops no slower than by hand.
+
+template <typename Body>
+double seconds(Body body)
+{
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+template <typename View>
+double seconds(const View &view, long long &sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long s = 0;
+    for (auto x : view)
+    {
+        s += x;
+    }
+    sum = s;
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+template <typename View>
+void print_sizes(const char *name, const View &view)
+{
+    auto common = itertools::common(view);
+    std::cout << name << " sizeof(begin)=" << sizeof(view.begin()) << " sizeof(end)=" << sizeof(view.end())
+              << " common: sizeof(begin)=" << sizeof(common.begin()) << " sizeof(end)=" << sizeof(common.end()) << std::endl;
+}
+
+int main()
+{
+    std::size_t n = std::size_t(1) << 24;
+    std::vector<int> data(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        data[i] = static_cast<int>(i % 1000);
+    }
+    data.push_back(-1);
+    long long hand_sum = 0, sentinel_sum = 0, common_sum = 0;
+    seconds(data, common_sum); // warm up
+
+    auto positive = [](int x) { return x >= 0; };
+    auto taken = itertools::takewhile(positive, data);
+    double hand = seconds([&] {
+        for (auto it = data.begin(); it != data.end() && positive(*it); ++it)
+        {
+            hand_sum += *it;
+        }
+    });
+    double sentinel = seconds(taken, sentinel_sum);
+    double common = seconds(itertools::common(taken), common_sum);
+    print_sizes("takewhile", taken);
+    std::cout << "takewhile hand=" << hand << " sentinel=" << sentinel << " common=" << common
+              << " (sums " << hand_sum << " " << sentinel_sum << " " << common_sum << ")" << std::endl;
+
+    // zip wraps count() in common_iterator on its own, so there is no common() run to compare with
+    hand_sum = sentinel_sum = 0;
+    hand = seconds([&] {
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            hand_sum += static_cast<long long>(i) * data[i];
+        }
+    });
+    sentinel = seconds([&] {
+        for (auto [i, x] : itertools::zip(itertools::count(0ll, 1ll), data))
+        {
+            sentinel_sum += i * x;
+        }
+    });
+    print_sizes("count", itertools::count(0ll, 1ll));
+    std::cout << "zip(count) hand=" << hand << " sentinel=" << sentinel
+              << " (sums " << hand_sum << " " << sentinel_sum << ")" << std::endl;
+
+    hand_sum = sentinel_sum = common_sum = 0;
+    int value = 3;
+    auto repeated = itertools::repeat(value, n);
+    hand = seconds([&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            hand_sum += value;
+        }
+    });
+    sentinel = seconds(repeated, sentinel_sum);
+    common = seconds(itertools::common(repeated), common_sum);
+    print_sizes("repeat", repeated);
+    std::cout << "repeat hand=" << hand << " sentinel=" << sentinel << " common=" << common
+              << " (sums " << hand_sum << " " << sentinel_sum << " " << common_sum << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,9 @@
+#include <itertools/itertools.hpp>
+#include <list>
+#include <ranges>
+#include <iostream>
+int main() {
+    std::list<int> l{1,2,3};
+    auto v = itertools::combinations_with_replacement<2>(l);
+    for (auto [a,b] : v | std::views::take(2)) std::cout << a << b << "\n";
+}
@@ -26,14 +26,32 @@
  * 
  * If func is supplied, it should be a function of two arguments. 
  * Elements of the input iterable may be any type that can be accepted as arguments to func.
+ *
+ * accumulate_into() is the eager counterpart, which writes all the running values to an output
+ * iterator, either sequentially or with a parallel blocked scan.
  */
 
 #pragma once
 
+#include <itertools/bitmask.hpp>
+#include <itertools/iterator_traits.hpp>
+#include <itertools/parallel.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace itertools
 {
@@ -41,8 +59,16 @@ namespace itertools
     class accumulate_iterator
     {
     public:
-        accumulate_iterator(Iterator it, S init, Fn fn)
-            : _M_it(it), _M_s(init), _M_fn(fn)
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = S;
+        using value_type = S;
+        using pointer = void;
+
+        accumulate_iterator() = default;
+
+        accumulate_iterator(Iterator it, Iterator last, S init, Fn fn)
+            : _M_it(it), _M_last(last), _M_s(init), _M_fn(fn)
         {
         }
 
@@ -51,12 +77,42 @@ namespace itertools
             return _M_s;
         }
 
+        /// \brief The last element is not followed by another to fold in, and last cannot be dereferenced.
         accumulate_iterator &operator++()
         {
-            _M_s = _M_fn(std::move(_M_s), *(++_M_it));
+            if (++_M_it != _M_last)
+            {
+                _M_s = _M_fn(std::move(_M_s), *_M_it);
+            }
             return *this;
         }
 
+        accumulate_iterator operator++(int)
+        {
+            accumulate_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        std::ptrdiff_t split_distance(const accumulate_iterator &other) const
+        {
+            return itertools::split_distance(_M_it, other._M_it);
+        }
+
+        /// \brief The running value depends on every element before it, so they are all folded in, in linear time.
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const accumulate_iterator &last)
+        {
+            std::ptrdiff_t k = 0;
+            for (; k != n && _M_it != last._M_it; ++k)
+            {
+                if (++_M_it != last._M_it)
+                {
+                    _M_s = _M_fn(std::move(_M_s), *_M_it);
+                }
+            }
+            return k;
+        }
+
         bool operator==(const accumulate_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -69,8 +125,9 @@ namespace itertools
 
     private:
         Iterator _M_it;
+        Iterator _M_last;
         S _M_s;
-        Fn _M_fn;
+        copyable_box<Fn> _M_fn;
     };
 
     template <class TL, class TR, class TResult>
@@ -82,27 +139,209 @@ namespace itertools
     template <typename Iterator, typename S, typename Fn>
     auto accumulate(Iterator first, Iterator last, S init, Fn fn)
     {
-        accumulate_iterator<Iterator, S, Fn> a_it_first(first, (first == last) ? init : fn(init, *first), fn);
-        accumulate_iterator<Iterator, S, Fn> a_it_last(last, init, fn);
+        accumulate_iterator<Iterator, S, Fn> a_it_first(first, last, (first == last) ? init : fn(init, *first), fn);
+        accumulate_iterator<Iterator, S, Fn> a_it_last(last, last, init, fn);
         return range_view(a_it_first, a_it_last);
     }
 
     template <typename Iterable, typename S, typename Fn>
     auto accumulate(const Iterable &iterable, S init, Fn fn)
     {
-        return accumulate(iterable.begin(), iterable.end(), init, fn);
+        return itertools::accumulate(common_begin(iterable), common_end(iterable), init, fn);
     }
 
     template <typename Iterator, typename S>
     auto accumulate(Iterator first, Iterator last, S init)
     {
-        return accumulate(first, last, init, plus<S, decltype(*first), S>());
+        return itertools::accumulate(first, last, init, plus<S, decltype(*first), S>());
     }
 
     template <typename Iterable, typename S>
     auto accumulate(const Iterable &iterable, S init)
     {
-        return accumulate(iterable.begin(), iterable.end(), init, plus<S, decltype(*iterable.begin()), S>());
+        return itertools::accumulate(common_begin(iterable), common_end(iterable), init, plus<S, decltype(*iterable.begin()), S>());
+    }
+
+    /// \brief Whether Fn adds two S into an S, with no conversion that the kernel would skip:
+    /// std::plus<S>, std::plus<>, or plus<S, S, S> up to references and cv-qualifiers on its right operand.
+    template <typename Fn, typename S>
+    struct is_plus : std::false_type
+    {
+    };
+
+    template <class TR, class S>
+    struct is_plus<plus<S, TR, S>, S> : std::is_same<std::remove_cv_t<std::remove_reference_t<TR>>, S>
+    {
+    };
+
+    template <typename S>
+    struct is_plus<std::plus<S>, S> : std::true_type
+    {
+    };
+
+    template <typename S>
+    struct is_plus<std::plus<void>, S> : std::true_type
+    {
+    };
+
+    /// \brief Whether out[i] = init + x[0] + ... + x[i] may be computed with scan_plus.
+    template <typename InputIt, typename OutputIt, typename S, typename Fn>
+    constexpr bool has_scan_plus_kernel()
+    {
+        using in_t = typename std::iterator_traits<InputIt>::value_type;
+        if constexpr (is_plus<Fn, S>::value && is_contiguous_iterator<InputIt>::value && is_contiguous_iterator<OutputIt>::value)
+        {
+            using out_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<OutputIt &>())>>;
+            return std::is_integral_v<S> && std::is_same_v<in_t, S> && std::is_same_v<out_t, S> &&
+                   (sizeof(S) == 4 || sizeof(S) == 8);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /// \brief out[i] = acc + first[0] + ... + first[i] for 32- and 64-bit integers; returns the last sum.
+    ///
+    /// Integers wrap around, so summing in any order gives the same results as the lazy view.
+    /// With SSE2, each block of 128 bits is scanned in registers with two shifted adds, and the
+    /// last lane is broadcast as the carry into the next block. out may be first.
+    template <typename T>
+    T scan_plus(const T *first, const T *last, T *out, T acc)
+    {
+        using U = std::make_unsigned_t<T>;
+#if defined(__SSE2__)
+        if constexpr (sizeof(T) == 4)
+        {
+            __m128i carry = _mm_set1_epi32(static_cast<int>(acc));
+            for (; last - first >= 4; first += 4, out += 4)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), x);
+                carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            acc = static_cast<T>(_mm_cvtsi128_si32(carry));
+        }
+        else
+        {
+            __m128i carry = _mm_set1_epi64x(static_cast<long long>(acc));
+            for (; last - first >= 2; first += 2, out += 2)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi64(x, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), x);
+                carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 2, 3, 2));
+            }
+            alignas(16) T lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i *>(lanes), carry);
+            acc = lanes[0];
+        }
+#endif
+        for (; first != last; ++first, ++out)
+        {
+            acc = static_cast<T>(static_cast<U>(acc) + static_cast<U>(*first));
+            *out = acc;
+        }
+        return acc;
+    }
+
+    /// \brief Write the running values of fn from init over [first, last) to out, one after another.
+    template <typename InputIt, typename OutputIt, typename S, typename Fn>
+    OutputIt accumulate_into(InputIt first, InputIt last, OutputIt out, S init, Fn fn, parallel::sequenced_policy)
+    {
+        if constexpr (has_scan_plus_kernel<InputIt, OutputIt, S, Fn>())
+        {
+            std::ptrdiff_t n = last - first;
+            if (n != 0)
+            {
+                scan_plus(&*first, &*first + n, &*out, init);
+            }
+            return out + n;
+        }
+        else
+        {
+            for (; first != last; ++first, ++out)
+            {
+                init = fn(std::move(init), *first);
+                *out = init;
+            }
+            return out;
+        }
+    }
+
+    /// \brief Write the running values of fn from init over [first, last) to out, with a blocked scan on the pool.
+    ///
+    /// The input is cut into chunks; the first pass folds every chunk on its own, the partial folds are
+    /// then chained in order from init, and the second pass scans every chunk again from the value
+    /// before it. fn must be associative and also accept two partial folds, fn(S, S), and elements must
+    /// convert to S. The results are those of the lazy view, except for the rounding of floating point
+    /// values, which are added in a different order. out must be a forward iterator.
+    template <typename InputIt, typename OutputIt, typename S, typename Fn>
+    OutputIt accumulate_into(InputIt first, InputIt last, OutputIt out, S init, Fn fn, parallel::parallel_policy policy)
+    {
+        parallel::thread_pool &pool = policy.pool();
+        range_view<InputIt> input(first, last);
+        std::size_t n = split_distance(first, last);
+        // every element is visited twice, so a chunk must be large enough to pay for the extra pass,
+        // and a single worker would only pay for it
+        std::size_t chunks_wanted = parallel::chunk_count(n, pool.size(), 1 << 14);
+        if (chunks_wanted < 2 || pool.size() < 2)
+        {
+            return accumulate_into(first, last, out, std::move(init), fn, parallel::seq);
+        }
+        auto chunks = chunk(input, chunks_wanted);
+
+        std::vector<std::unique_ptr<S>> partials(chunks.size());
+        parallel::parallel_chunks(pool, chunks.size(), [&](std::size_t c) {
+            auto it = chunks[c].begin();
+            auto it_last = chunks[c].end();
+            if (it == it_last)
+            {
+                return;
+            }
+            S acc(*it);
+            for (++it; it != it_last; ++it)
+            {
+                acc = fn(std::move(acc), *it);
+            }
+            partials[c] = std::make_unique<S>(std::move(acc));
+        });
+
+        std::vector<S> prefixes;
+        std::vector<OutputIt> outs;
+        prefixes.reserve(chunks.size());
+        outs.reserve(chunks.size());
+        for (std::size_t c = 0; c != chunks.size(); ++c)
+        {
+            prefixes.push_back(init);
+            outs.push_back(out);
+            if (partials[c])
+            {
+                init = fn(std::move(init), *partials[c]);
+            }
+            std::advance(out, split_distance(chunks[c].begin(), chunks[c].end()));
+        }
+
+        parallel::parallel_chunks(pool, chunks.size(), [&](std::size_t c) {
+            accumulate_into(chunks[c].begin(), chunks[c].end(), outs[c], std::move(prefixes[c]), fn, parallel::seq);
+        });
+        return out;
+    }
+
+    template <typename InputIt, typename OutputIt, typename S, typename Fn>
+    OutputIt accumulate_into(InputIt first, InputIt last, OutputIt out, S init, Fn fn)
+    {
+        return accumulate_into(first, last, out, std::move(init), fn, parallel::seq);
+    }
+
+    template <typename InputIt, typename OutputIt, typename S>
+    OutputIt accumulate_into(InputIt first, InputIt last, OutputIt out, S init)
+    {
+        return accumulate_into(first, last, out, std::move(init), plus<S, decltype(*first), S>(), parallel::seq);
     }
 
 } // namespace itertools
@@ -0,0 +1,280 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file bitmask.hpp
+ *
+ * Evaluate a predicate over a block of up to 64 contiguous elements into the bits of a std::uint64_t,
+ * and walk the set bits; filter and compress use them to select elements in bulk.
+ *
+ * Masks that are already packed into bits (bitmask_view, std::bitset, std::vector<bool>) are
+ * searched with find_next_set(), which skips zero words of a bitmask_view, and of a std::bitset or a
+ * std::vector<bool> with libstdc++; elsewhere the standard containers are searched bit by bit.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <bitset>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace itertools
+{
+    /// \brief Index of the lowest set bit; x must not be zero.
+    inline int countr_zero(std::uint64_t x)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        int n = 0;
+        for (; !(x & 1); x >>= 1)
+        {
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    template <typename Iterator, typename T>
+    constexpr bool is_vector_iterator()
+    {
+        if constexpr (std::is_void_v<T> || std::is_same_v<T, bool>)
+        {
+            return false;
+        }
+        else
+        {
+            return std::is_same_v<Iterator, typename std::vector<T>::iterator> ||
+                   std::is_same_v<Iterator, typename std::vector<T>::const_iterator>;
+        }
+    }
+
+    /// \brief Iterators known to point into an array: pointers, and those of std::vector.
+    template <typename Iterator, typename = void>
+    struct is_contiguous_iterator : std::is_pointer<Iterator>
+    {
+    };
+
+    template <typename Iterator>
+    struct is_contiguous_iterator<Iterator, std::void_t<typename Iterator::value_type>>
+        : std::bool_constant<is_vector_iterator<Iterator, typename Iterator::value_type>()>
+    {
+    };
+
+    /// \brief Contiguous iterators to integers, over which a predicate may be evaluated in blocks.
+    ///
+    /// Floating point values are left to the plain iterators: the compiler does not vectorize their
+    /// comparisons into a mask, and a branch per element is faster than building one bit by bit.
+    template <typename Iterator>
+    constexpr bool is_blockable_iterator()
+    {
+        if constexpr (is_contiguous_iterator<Iterator>::value)
+        {
+            return std::is_integral_v<typename std::iterator_traits<Iterator>::value_type>;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /// \brief Bit i is set if p[i] is not zero, for i < n <= 64.
+    ///
+    /// Full blocks of bytes (bool, char, std::uint8_t) are compared 16 at a time with SSE2.
+    template <typename T>
+    std::uint64_t nonzero_mask(const T *p, std::size_t n)
+    {
+#if defined(__SSE2__)
+        if constexpr (sizeof(T) == 1)
+        {
+            if (n == 64)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                std::uint64_t zeros = 0;
+                for (int i = 0; i != 4; ++i)
+                {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p) + i);
+                    zeros |= std::uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)))) << (16 * i);
+                }
+                return ~zeros;
+            }
+        }
+#endif
+        std::uint64_t mask = 0;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            mask |= std::uint64_t(p[i] != T(0)) << i;
+        }
+        return mask;
+    }
+
+    /// \brief Bit i is set if pred(p[i]), for i < n <= 64.
+    ///
+    /// A full block is first evaluated into 64 bytes, in a loop of constant length without branches
+    /// that the compiler may vectorize for simple comparisons, and the bytes are then packed into bits.
+    template <typename T, typename Pred>
+    std::uint64_t predicate_mask(T *p, std::size_t n, Pred &pred)
+    {
+        if (n == 64)
+        {
+            unsigned char selected[64];
+            for (std::size_t i = 0; i != 64; ++i)
+            {
+                selected[i] = static_cast<bool>(pred(p[i]));
+            }
+            return nonzero_mask(selected, 64);
+        }
+        std::uint64_t mask = 0;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            mask |= std::uint64_t(static_cast<bool>(pred(p[i]))) << i;
+        }
+        return mask;
+    }
+
+    /// \brief A mask of size bits packed into 64-bit words, bit i being bit i % 64 of word i / 64.
+    ///
+    /// The words are not owned. Bits of the last word past size are ignored.
+    class bitmask_view
+    {
+    public:
+        bitmask_view() = default;
+
+        bitmask_view(const std::uint64_t *words, std::size_t size)
+            : _M_words(words), _M_size(size)
+        {
+        }
+
+        std::size_t size() const { return _M_size; }
+
+        bool operator[](std::size_t i) const
+        {
+            return (_M_words[i / 64] >> (i % 64)) & 1;
+        }
+
+        /// \brief Index of the first set bit at or after i, or size() if there is none.
+        std::size_t find_next(std::size_t i) const
+        {
+            if (i >= _M_size)
+            {
+                return _M_size;
+            }
+            std::size_t w = i / 64;
+            std::size_t words = (_M_size + 63) / 64;
+            std::uint64_t word = _M_words[w] & (~std::uint64_t(0) << (i % 64));
+            while (word == 0)
+            {
+                if (++w == words)
+                {
+                    return _M_size;
+                }
+                word = _M_words[w];
+            }
+            return std::min(w * 64 + countr_zero(word), _M_size);
+        }
+
+    private:
+        const std::uint64_t *_M_words = nullptr;
+        std::size_t _M_size = 0;
+    };
+
+    inline std::size_t find_next_set(const bitmask_view &bits, std::size_t i)
+    {
+        return bits.find_next(i);
+    }
+
+    template <std::size_t N>
+    std::size_t find_next_set(const std::bitset<N> &bits, std::size_t i)
+    {
+        if (i >= N)
+        {
+            return N;
+        }
+#if defined(__GLIBCXX__)
+        // GNU extensions that skip zero words
+        return i == 0 ? bits._Find_first() : bits._Find_next(i - 1);
+#else
+        for (; i != N && !bits[i]; ++i)
+            ;
+        return i;
+#endif
+    }
+
+    inline std::size_t find_next_set(const std::vector<bool> &bits, std::size_t i)
+    {
+        std::size_t size = bits.size();
+        if (i >= size)
+        {
+            return size;
+        }
+#if defined(__GLIBCXX__) && !defined(_GLIBCXX_DEBUG)
+        // libstdc++ stores the bits from bit 0 of the word its iterators point to, so skip zero words
+        using word_t = std::remove_pointer_t<decltype(bits.begin()._M_p)>;
+        constexpr std::size_t word_bits = sizeof(word_t) * 8;
+        const word_t *words = bits.begin()._M_p;
+        std::size_t w = i / word_bits;
+        std::size_t last = (size + word_bits - 1) / word_bits;
+        word_t word = words[w] & (~word_t(0) << (i % word_bits));
+        while (word == 0)
+        {
+            if (++w == last)
+            {
+                return size;
+            }
+            word = words[w];
+        }
+        return std::min(w * word_bits + countr_zero(word), size);
+#else
+        for (; i != size && !bits[i]; ++i)
+            ;
+        return i;
+#endif
+    }
+
+    template <typename Bits>
+    struct is_packed_bitmask : std::false_type
+    {
+    };
+
+    template <>
+    struct is_packed_bitmask<bitmask_view> : std::true_type
+    {
+    };
+
+    template <std::size_t N>
+    struct is_packed_bitmask<std::bitset<N>> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_packed_bitmask<std::vector<bool>> : std::true_type
+    {
+    };
+
+} // namespace itertools
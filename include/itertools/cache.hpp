@@ -0,0 +1,218 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file cache.hpp
+ *
+ * Evaluate an iterable once, lazily, and keep its elements for the next passes.
+ *
+ * The first pass over the view pulls the elements from upstream as it needs them, and stores them in
+ * chunks of memory that are never reallocated, so elements are never moved, and references to them
+ * stay valid as long as the view. Later passes, and iterators behind the first one, read the chunks.
+ * Copies of the view share the same cache.
+ */
+
+#pragma once
+
+#include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace itertools
+{
+    template <typename Iterator>
+    class cache_state
+    {
+    public:
+        using value_type = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator &>())>>;
+
+        /// \brief Elements per chunk: about 4 KiB worth, and at least 16.
+        static constexpr std::size_t chunk_size = sizeof(value_type) < 256 ? 4096 / sizeof(value_type) : 16;
+
+        cache_state(Iterator first, Iterator last)
+            : _M_it(first), _M_last(last)
+        {
+        }
+
+        cache_state(const cache_state &) = delete;
+
+        cache_state &operator=(const cache_state &) = delete;
+
+        ~cache_state()
+        {
+            for (std::size_t i = 0; i != _M_size; ++i)
+            {
+                (*this)[i].~value_type();
+            }
+            for (value_type *chunk : _M_chunks)
+            {
+                ::operator delete(chunk);
+            }
+        }
+
+        /// \brief Whether the iterable has fewer than i + 1 elements; evaluates it up to i to tell.
+        bool at_end(std::size_t i)
+        {
+            while (_M_size <= i)
+            {
+                if (_M_it == _M_last)
+                {
+                    return true;
+                }
+                // a chunk is only added when the last one is full, so that if upstream threw after adding
+                // one, the next attempt fills it instead of adding another
+                if (_M_size == _M_chunks.size() * chunk_size)
+                {
+                    value_type *chunk = static_cast<value_type *>(::operator new(chunk_size * sizeof(value_type)));
+                    try
+                    {
+                        _M_chunks.push_back(chunk);
+                    }
+                    catch (...)
+                    {
+                        ::operator delete(chunk);
+                        throw;
+                    }
+                }
+                new (&_M_chunks.back()[_M_size % chunk_size]) value_type(*_M_it);
+                ++_M_size;
+                ++_M_it;
+            }
+            return false;
+        }
+
+        /// \brief Element i, which must have been evaluated.
+        const value_type &operator[](std::size_t i) const
+        {
+            return _M_chunks[i / chunk_size][i % chunk_size];
+        }
+
+        /// \brief Number of elements evaluated so far.
+        std::size_t cached() const { return _M_size; }
+
+    private:
+        Iterator _M_it;
+        Iterator _M_last;
+        std::vector<value_type *> _M_chunks;
+        std::size_t _M_size = 0;
+    };
+
+    /// \brief Iterator over a cache: an index into it. The default constructed one is the end.
+    template <typename Iterator>
+    class cache_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename cache_state<Iterator>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        cache_iterator() = default;
+
+        cache_iterator(cache_state<Iterator> *state, std::size_t i)
+            : _M_state(state), _M_i(i)
+        {
+        }
+
+        reference operator*() const
+        {
+            _M_state->at_end(_M_i);
+            return (*_M_state)[_M_i];
+        }
+
+        cache_iterator &operator++()
+        {
+            ++_M_i;
+            return *this;
+        }
+
+        cache_iterator operator++(int)
+        {
+            cache_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const cache_iterator &other) const
+        {
+            if (_M_state && other._M_state)
+            {
+                return _M_i == other._M_i;
+            }
+            return at_end() == other.at_end();
+        }
+
+        bool operator!=(const cache_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        bool at_end() const
+        {
+            return _M_state == nullptr || _M_state->at_end(_M_i);
+        }
+
+        cache_state<Iterator> *_M_state = nullptr;
+        std::size_t _M_i = 0;
+    };
+
+    template <typename Iterator>
+    class cache_view : public view_base<cache_view<Iterator>>
+    {
+    public:
+        cache_view(Iterator first, Iterator last)
+            : _M_state(std::make_shared<cache_state<Iterator>>(first, last))
+        {
+        }
+
+        cache_iterator<Iterator> begin() const { return cache_iterator<Iterator>(_M_state.get(), 0); }
+
+        cache_iterator<Iterator> end() const { return cache_iterator<Iterator>(); }
+
+        /// \brief Number of elements evaluated so far.
+        std::size_t cached() const { return _M_state->cached(); }
+
+    private:
+        std::shared_ptr<cache_state<Iterator>> _M_state;
+    };
+
+    template <typename Iterator>
+    auto cache(Iterator first, Iterator last)
+    {
+        return cache_view<Iterator>(first, last);
+    }
+
+    template <typename Iterable>
+    auto cache(Iterable &&iterable)
+    {
+        return cache(common_begin(iterable), common_end(iterable));
+    }
+
+} // namespace itertools
@@ -24,12 +24,31 @@
  * Return a chain object whose .__next__() method returns elements from the
  * first iterable until it is exhausted, then elements from the next
  * iterable, until all of the iterables are exhausted.
+ *
+ * Stepping a chain iterator checks which iterable it is in; for_each and for_each_segment
+ * (see segmented.hpp) avoid that by looping over each iterable in turn.
+ *
+ * chain_from_iterable chains the iterables yielded by an iterable, e.g. a vector of vectors, whose number
+ * is only known at run time. When the inner and outer iterators can be subtracted, it keeps a table of
+ * where every inner iterable starts, and is random access: it seeks in O(log K) for K inner iterables.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/segmented.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace itertools
 {
@@ -41,6 +60,14 @@ namespace itertools
     class chain_iterator<Value, Iterator>
     {
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = Value &;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        chain_iterator() = default;
+
         chain_iterator(Iterator it, Iterator last)
             : _M_it(it), _M_it_last(last) {}
 
@@ -49,12 +76,35 @@ namespace itertools
             return *_M_it;
         }
 
-        chain_iterator operator++()
+        chain_iterator &operator++()
         {
             ++_M_it;
             return *this;
         }
 
+        chain_iterator operator++(int)
+        {
+            chain_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <typename Fn>
+        void for_each_segment(const chain_iterator &last, Fn &fn) const
+        {
+            itertools::for_each_segment(_M_it, last._M_it, fn);
+        }
+
+        std::ptrdiff_t split_distance(const chain_iterator &other) const
+        {
+            return itertools::split_distance(_M_it, other._M_it);
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const chain_iterator &last)
+        {
+            return itertools::split_advance(_M_it, n, last._M_it);
+        }
+
         bool operator==(const chain_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -75,6 +125,14 @@ namespace itertools
     class chain_iterator<Value, Iterator, Iterators...>
     {
     public:
+        using iterator_category = forward_iterator_category_t<Iterator, Iterators...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = Value &;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        chain_iterator() = default;
+
         template <typename... Args>
         chain_iterator(Iterator it, Iterator last, Args... rest)
             : _M_it(it), _M_it_last(last), _M_sub_chain_it(rest...) {}
@@ -84,7 +142,7 @@ namespace itertools
             return _M_it != _M_it_last ? *_M_it : *_M_sub_chain_it;
         }
 
-        chain_iterator operator++()
+        chain_iterator &operator++()
         {
             if (_M_it != _M_it_last)
             {
@@ -97,6 +155,49 @@ namespace itertools
             return *this;
         }
 
+        chain_iterator operator++(int)
+        {
+            chain_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /// \brief Call fn on the rest of the current iterable, then on the segments of the next ones.
+        template <typename Fn>
+        void for_each_segment(const chain_iterator &last, Fn &fn) const
+        {
+            if (last._M_it != _M_it_last)
+            {
+                // last is within the current iterable
+                itertools::for_each_segment(_M_it, last._M_it, fn);
+                return;
+            }
+            itertools::for_each_segment(_M_it, _M_it_last, fn);
+            _M_sub_chain_it.for_each_segment(last._M_sub_chain_it, fn);
+        }
+
+        /// \brief The sum of the distances within each iterable.
+        std::ptrdiff_t split_distance(const chain_iterator &other) const
+        {
+            return itertools::split_distance(_M_it, other._M_it) + _M_sub_chain_it.split_distance(other._M_sub_chain_it);
+        }
+
+        /// \brief Move within the current iterable, and spill what is left over into the next ones.
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const chain_iterator &last)
+        {
+            if (last._M_it != _M_it_last)
+            {
+                // last is within the current iterable
+                return itertools::split_advance(_M_it, n, last._M_it);
+            }
+            std::ptrdiff_t k = itertools::split_advance(_M_it, n, _M_it_last);
+            if (k != n)
+            {
+                k += _M_sub_chain_it.split_advance(n - k, last._M_sub_chain_it);
+            }
+            return k;
+        }
+
         bool operator==(const chain_iterator &other) const
         {
             return _M_it == other._M_it && _M_sub_chain_it == other._M_sub_chain_it;
@@ -117,15 +218,334 @@ namespace itertools
     auto chain(Iterable &&iterable, Iterables &&... iterables)
     {
         using value_type = decltype(*iterable.begin());
-        using chain_iterator_type = chain_iterator<value_type, decltype(iterable.begin()), decltype(iterables.begin())...>;
+        using chain_iterator_type = chain_iterator<value_type, common_iterator_t<Iterable>, common_iterator_t<Iterables>...>;
 
-        auto first = std::apply([&iterable, &iterables...](auto &&... args) { return chain_iterator_type(std::forward<decltype(args)>(args)...); },
-                                std::tuple_cat(std::make_tuple(iterable.begin(), iterable.end()), std::make_tuple(iterables.begin(), iterables.end())...));
+        // iterables that end with a sentinel, like count(), are wrapped in common_iterator
+        auto first = std::apply([](auto &&... args) { return chain_iterator_type(std::forward<decltype(args)>(args)...); },
+                                std::tuple_cat(std::make_tuple(common_begin(iterable), common_end(iterable)), std::make_tuple(common_begin(iterables), common_end(iterables))...));
 
-        auto last = std::apply([&iterable, &iterables...](auto &&... args) { return chain_iterator_type(std::forward<decltype(args)>(args)...); },
-                               std::tuple_cat(std::make_tuple(iterable.end(), iterable.end()), std::make_tuple(iterables.end(), iterables.end())...));
+        auto last = std::apply([](auto &&... args) { return chain_iterator_type(std::forward<decltype(args)>(args)...); },
+                               std::tuple_cat(std::make_tuple(common_end(iterable), common_end(iterable)), std::make_tuple(common_end(iterables), common_end(iterables))...));
 
         return range_view<chain_iterator_type>(first, last);
     }
 
+    template <typename OuterIterator>
+    class chain_from_iterable_iterator
+    {
+        using inner_iterator = decltype((*std::declval<const OuterIterator &>()).begin());
+
+        static constexpr bool indexed = is_subtractable<OuterIterator>::value && is_subtractable<inner_iterator>::value;
+
+    public:
+        using iterator_category = std::conditional_t<indexed, std::random_access_iterator_tag, std::forward_iterator_tag>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const inner_iterator &>());
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using pointer = void;
+
+        /// \brief Iterator to the first element of *outer or of the next non-empty inner iterable.
+        ///
+        /// starts is the table of where every inner iterable starts, followed by the total size; only when
+        /// indexed. It belongs to the view, which must outlive its iterators.
+        chain_from_iterable_iterator() = default;
+
+        chain_from_iterable_iterator(OuterIterator outer_first, OuterIterator outer, OuterIterator outer_last,
+                                     const std::vector<std::ptrdiff_t> *starts)
+            : _M_outer_first(outer_first), _M_outer(outer), _M_outer_last(outer_last), _M_starts(starts)
+        {
+            if (_M_outer != _M_outer_last)
+            {
+                _M_it = (*_M_outer).begin();
+                _M_it_last = (*_M_outer).end();
+                if (_M_it == _M_it_last)
+                {
+                    next_segment();
+                }
+            }
+        }
+
+        reference operator*() const
+        {
+            return *_M_it;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        /// \brief Empty inner iterables are skipped here, so that stepping within one needs a single test.
+        chain_from_iterable_iterator &operator++()
+        {
+            if (++_M_it == _M_it_last)
+            {
+                next_segment();
+            }
+            return *this;
+        }
+
+        chain_from_iterable_iterator operator++(int)
+        {
+            chain_from_iterable_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator &operator--()
+        {
+            return *this -= 1;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator operator--(int)
+        {
+            chain_from_iterable_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator &operator+=(difference_type n)
+        {
+            seek(position() + n);
+            return *this;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator &operator-=(difference_type n)
+        {
+            seek(position() - n);
+            return *this;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator operator+(difference_type n) const
+        {
+            return chain_from_iterable_iterator(*this) += n;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        friend chain_from_iterable_iterator operator+(difference_type n, const chain_from_iterable_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        chain_from_iterable_iterator operator-(difference_type n) const
+        {
+            return chain_from_iterable_iterator(*this) -= n;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        difference_type operator-(const chain_from_iterable_iterator &other) const
+        {
+            return position() - other.position();
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        bool operator<(const chain_from_iterable_iterator &other) const
+        {
+            return position() < other.position();
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        bool operator>(const chain_from_iterable_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        bool operator<=(const chain_from_iterable_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = indexed, typename = std::enable_if_t<RA>>
+        bool operator>=(const chain_from_iterable_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
+        /// \brief Call fn on the rest of the current inner iterable, then on the next ones up to last.
+        template <typename Fn>
+        void for_each_segment(const chain_from_iterable_iterator &last, Fn &fn) const
+        {
+            if (_M_outer == _M_outer_last)
+            {
+                return;
+            }
+            if (_M_outer == last._M_outer)
+            {
+                itertools::for_each_segment(_M_it, last._M_it, fn);
+                return;
+            }
+            itertools::for_each_segment(_M_it, _M_it_last, fn);
+            OuterIterator outer = _M_outer;
+            for (++outer; outer != last._M_outer; ++outer)
+            {
+                itertools::for_each_segment((*outer).begin(), (*outer).end(), fn);
+            }
+            if (last._M_outer != _M_outer_last)
+            {
+                itertools::for_each_segment((*last._M_outer).begin(), last._M_it, fn);
+            }
+        }
+
+        /// \brief Difference of positions when indexed, or the sum of the distances within each inner iterable.
+        std::ptrdiff_t split_distance(const chain_from_iterable_iterator &other) const
+        {
+            if constexpr (indexed)
+            {
+                return other - *this;
+            }
+            else
+            {
+                std::ptrdiff_t n = 0;
+                auto count = [&n](auto first, auto last) { n += itertools::split_distance(first, last); };
+                for_each_segment(other, count);
+                return n;
+            }
+        }
+
+        /// \brief Seek when indexed, or move within the inner iterables one after the other.
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const chain_from_iterable_iterator &last)
+        {
+            if constexpr (indexed)
+            {
+                n = std::min(n, last - *this);
+                *this += n;
+                return n;
+            }
+            else
+            {
+                std::ptrdiff_t k = 0;
+                while (k != n && *this != last)
+                {
+                    if (_M_outer == last._M_outer)
+                    {
+                        k += itertools::split_advance(_M_it, n - k, last._M_it);
+                        break;
+                    }
+                    k += itertools::split_advance(_M_it, n - k, _M_it_last);
+                    if (_M_it == _M_it_last)
+                    {
+                        next_segment();
+                    }
+                }
+                return k;
+            }
+        }
+
+        bool operator==(const chain_from_iterable_iterator &other) const
+        {
+            return _M_outer == other._M_outer && (_M_outer == _M_outer_last || _M_it == other._M_it);
+        }
+
+        bool operator!=(const chain_from_iterable_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        /// \brief Move to the first element of the next non-empty inner iterable, or to the end.
+        void next_segment()
+        {
+            while (++_M_outer != _M_outer_last)
+            {
+                _M_it = (*_M_outer).begin();
+                _M_it_last = (*_M_outer).end();
+                if (_M_it != _M_it_last)
+                {
+                    return;
+                }
+            }
+        }
+
+        std::ptrdiff_t position() const
+        {
+            if (_M_outer == _M_outer_last)
+            {
+                return _M_starts->back();
+            }
+            return (*_M_starts)[_M_outer - _M_outer_first] + (_M_it - (*_M_outer).begin());
+        }
+
+        /// \brief Move to position p, in the last inner iterable starting at or before p, which is not empty.
+        void seek(std::ptrdiff_t p)
+        {
+            if (p == _M_starts->back())
+            {
+                _M_outer = _M_outer_last;
+                return;
+            }
+            auto k = std::upper_bound(_M_starts->begin(), _M_starts->end(), p) - _M_starts->begin() - 1;
+            _M_outer = _M_outer_first;
+            _M_outer += k;
+            _M_it = (*_M_outer).begin();
+            _M_it += p - (*_M_starts)[k];
+            _M_it_last = (*_M_outer).end();
+        }
+
+        OuterIterator _M_outer_first;
+        OuterIterator _M_outer;
+        OuterIterator _M_outer_last;
+        inner_iterator _M_it{};
+        inner_iterator _M_it_last{};
+        const std::vector<std::ptrdiff_t> *_M_starts = nullptr;
+    };
+
+    /// \brief View of chain_from_iterable; copies share the table of starts, which iterators point to, so
+    /// the iterators are valid as long as the view or one of its copies.
+    template <typename OuterIterator>
+    class chain_from_iterable_view : public view_base<chain_from_iterable_view<OuterIterator>>
+    {
+        using iterator = chain_from_iterable_iterator<OuterIterator>;
+
+    public:
+        chain_from_iterable_view(OuterIterator first, OuterIterator last)
+            : _M_first(first), _M_last(last)
+        {
+            if constexpr (std::is_same_v<typename iterator::iterator_category, std::random_access_iterator_tag>)
+            {
+                auto starts = std::make_shared<std::vector<std::ptrdiff_t>>(1, 0);
+                starts->reserve(last - first + 1);
+                for (; first != last; ++first)
+                {
+                    starts->push_back(starts->back() + ((*first).end() - (*first).begin()));
+                }
+                _M_starts = std::move(starts);
+            }
+        }
+
+        iterator begin() const { return iterator(_M_first, _M_first, _M_last, _M_starts.get()); }
+
+        iterator end() const { return iterator(_M_first, _M_last, _M_last, _M_starts.get()); }
+
+        /// \brief Number of elements; only for random access, since the table of starts is not built otherwise.
+        template <bool RA = std::is_same_v<typename iterator::iterator_category, std::random_access_iterator_tag>,
+                  typename = std::enable_if_t<RA>>
+        std::size_t size() const { return _M_starts->back(); }
+
+    private:
+        OuterIterator _M_first;
+        OuterIterator _M_last;
+        std::shared_ptr<const std::vector<std::ptrdiff_t>> _M_starts;
+    };
+
+    template <typename OuterIterator>
+    auto chain_from_iterable(OuterIterator first, OuterIterator last)
+    {
+        return chain_from_iterable_view<OuterIterator>(first, last);
+    }
+
+    /// \brief Chain the iterables of iterable, which must yield references to them, e.g. a vector of vectors.
+    template <typename Iterable>
+    auto chain_from_iterable(Iterable &&iterable)
+    {
+        return chain_from_iterable(iterable.begin(), iterable.end());
+    }
+
 } // namespace itertools
@@ -28,111 +28,315 @@
 
 #pragma once
 
+#include <itertools/indirect_view.hpp>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace itertools
 {
-    template <std::size_t N, typename Iterator>
-    class combinations_iterator;
+    /// \brief Binomial coefficient C(n, k); saturates at the maximum of std::size_t instead of overflowing.
+    inline std::size_t binomial(std::size_t n, std::size_t k)
+    {
+        if (k > n)
+        {
+            return 0;
+        }
+        k = std::min(k, n - k);
+        std::size_t c = 1;
+        for (std::size_t i = 1; i <= k; ++i)
+        {
+            // c * m / i is exact; divide by the common factor first so that only the result may overflow
+            std::size_t m = n - k + i;
+            std::size_t g = std::gcd(c, i);
+            std::size_t f = m / (i / g);
+            if (c / g > std::numeric_limits<std::size_t>::max() / f)
+            {
+                return std::numeric_limits<std::size_t>::max();
+            }
+            c = c / g * f;
+        }
+        return c;
+    }
 
-    // base case: N = 1, behaves much like "regular" iterator.
+    /// \brief Largest e <= hi such that C(e, k) <= x.
+    ///
+    /// This is one digit of x in the combinatorial number system.
+    /// If hi is not given, an upper bound is first found by doubling.
+    inline std::size_t combinadic_digit(std::size_t x, std::size_t k, std::size_t hi = std::numeric_limits<std::size_t>::max())
+    {
+        std::size_t lo = k - 1; // C(k - 1, k) == 0 <= x
+        if (hi == std::numeric_limits<std::size_t>::max())
+        {
+            for (hi = std::max<std::size_t>(k, 1); binomial(hi, k) <= x; hi *= 2)
+            {
+                lo = hi;
+            }
+        }
+        // invariant: C(lo, k) <= x, and either lo == hi or C(hi, k) > x
+        while (lo < hi)
+        {
+            std::size_t mid = lo + (hi - lo + 1) / 2;
+            if (binomial(mid, k) <= x)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        return lo;
+    }
+
+    /// \brief Write x as C(e[0], k) + C(e[1], k - 1) + ... + C(e[k - 1], 1), with e[0] > e[1] > ... > e[k - 1] >= 0.
+    ///
+    /// fn(i, e[i]) is called for i = 0, ..., k - 1.
+    template <typename Fn>
+    void combinadic(std::size_t x, std::size_t k, Fn fn)
+    {
+        std::size_t hi = std::numeric_limits<std::size_t>::max();
+        for (std::size_t i = 0; i != k; ++i)
+        {
+            std::size_t e = combinadic_digit(x, k - i, hi);
+            x -= binomial(e, k - i);
+            fn(i, e);
+            hi = e - 1;
+        }
+    }
+
+    // Combinations are ranked from the end of the sequence, so that only the last input iterator
+    // is needed: with e[i] = last - 1 - its[i], the combinations after the current one are numbered
+    // by sum(C(e[i], r - i)) (the combinatorial number system). The combinations remaining,
+    // including the current one, are 1 more than that, and 0 at the end.
+
+    /// \brief Number of combinations from its[0, r) (inclusive) to the end.
+    template <typename Iterator>
+    std::ptrdiff_t combinations_remaining(const Iterator *its, std::size_t r, Iterator last)
+    {
+        std::size_t n = 1;
+        for (std::size_t i = 0; i != r; ++i)
+        {
+            n += binomial(last - its[i] - 1, r - i);
+        }
+        return n;
+    }
+
+    /// \brief Set its[0, r) to the combination that has n combinations remaining; n > 0.
+    template <typename Iterator>
+    void combinations_seek(Iterator *its, std::size_t r, Iterator last, std::ptrdiff_t n)
+    {
+        combinadic(n - 1, r, [its, last](std::size_t i, std::size_t e) { its[i] = last - 1 - e; });
+    }
+
+    /// \brief Advance its[0, r) to the next combination; slot i may not reach lasts[i].
+    ///
+    /// \return false if there is no next combination; then its[0] == lasts[0].
     template <typename Iterator>
-    class combinations_iterator<1, Iterator>
+    bool next_combination(Iterator *its, const Iterator *lasts, std::size_t r)
+    {
+        // find the rightmost slot that can still advance, then pack the following slots behind it
+        for (std::size_t i = r; i-- > 0;)
+        {
+            if (++its[i] != lasts[i])
+            {
+                for (std::size_t j = i + 1; j != r; ++j)
+                {
+                    its[j] = std::next(its[j - 1]);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// combinations_iterator keeps the N selected iterators, and the (exclusive) last position each of them may take.
+    ///
+    /// When Iterator is random access, so is combinations_iterator.
+    template <std::size_t N, typename Iterator>
+    class combinations_iterator
     {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
     public:
+        using iterator_category = view_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = tuple_of_n_t<decltype(*std::declval<const Iterator &>()), N>;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        /// \brief it is the first selected iterator; it_last is the position it may not reach.
+        combinations_iterator() = default;
+
         combinations_iterator(Iterator it, Iterator it_last)
-            : _M_it(it), _M_it_last(it_last) {}
+        {
+            for (std::size_t i = 0; i != N; ++i)
+            {
+                _M_its[i] = it;
+                _M_lasts[i] = it_last;
+                if (i + 1 != N)
+                {
+                    ++it;
+                    ++it_last;
+                }
+            }
+        }
+
+        /// \brief An exhausted iterator, that never moves past last.
+        explicit combinations_iterator(Iterator last)
+        {
+            _M_its.fill(last);
+            _M_lasts.fill(last);
+        }
 
-        void rewind(Iterator it)
+        /// \brief Number of combinations from this position to the end.
+        difference_type remaining() const
         {
-            _M_it = it;
+            return _M_its[0] == _M_lasts[0] ? 0 : combinations_remaining(_M_its.data(), N, _M_lasts[N - 1]);
         }
 
-        bool exhausted() const
+        /// \brief Move to the position that has n combinations remaining.
+        void seek(difference_type n)
         {
-            return _M_it == _M_it_last;
+            if (n == 0)
+            {
+                _M_its = _M_lasts;
+            }
+            else
+            {
+                combinations_seek(_M_its.data(), N, _M_lasts[N - 1], n);
+            }
         }
 
         decltype(auto) operator*() const
         {
-            return std::make_tuple(*_M_it);
+            return deref_impl(std::make_index_sequence<N>());
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        decltype(auto) operator[](difference_type n) const
+        {
+            return *(*this + n);
         }
 
         combinations_iterator &operator++()
         {
-            ++_M_it;
+            next_combination(_M_its.data(), _M_lasts.data(), N);
             return *this;
         }
 
-        bool operator==(const combinations_iterator &other)
+        combinations_iterator operator++(int)
         {
-            return _M_it == other._M_it;
+            combinations_iterator tmp = *this;
+            ++*this;
+            return tmp;
         }
 
-        bool operator!=(const combinations_iterator &other)
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator &operator--()
         {
-            return !(*this == other);
+            return *this -= 1;
         }
 
-    private:
-        Iterator _M_it;
-        Iterator _M_it_last;
-    };
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator operator--(int)
+        {
+            combinations_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
 
-    template <std::size_t N, typename Iterator>
-    class combinations_iterator
-    {
-    public:
-        combinations_iterator(Iterator it, Iterator it_last)
-            : _M_it(it), _M_it_last(it_last),
-              _M_sub_it(std::next(it), std::next(it_last))
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator &operator+=(difference_type n)
         {
+            seek(remaining() - n);
+            return *this;
         }
 
-        void rewind(Iterator it)
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator &operator-=(difference_type n)
         {
-            _M_it = it;
-            _M_sub_it.rewind(std::next(_M_it));
+            return *this += -n;
         }
 
-        bool exhausted() const
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator operator+(difference_type n) const
         {
-            return _M_it == _M_it_last;
+            return combinations_iterator(*this) += n;
         }
 
-        decltype(auto) operator*() const
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend combinations_iterator operator+(difference_type n, const combinations_iterator &it)
         {
-            return std::tuple_cat(std::make_tuple(*_M_it), *_M_sub_it);
+            return it + n;
         }
 
-        combinations_iterator &operator++()
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_iterator operator-(difference_type n) const
         {
-            if ((++_M_sub_it).exhausted())
-            {
-                ++_M_it;
-                _M_sub_it.rewind(std::next(_M_it));
-            }
-            return *this;
+            return combinations_iterator(*this) -= n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const combinations_iterator &other) const
+        {
+            return other.remaining() - remaining();
         }
 
-        bool operator==(const combinations_iterator &other)
+        bool operator==(const combinations_iterator &other) const
         {
-            return _M_it == other._M_it && _M_sub_it == other._M_sub_it;
+            return _M_its == other._M_its;
         }
 
-        bool operator!=(const combinations_iterator &other)
+        bool operator!=(const combinations_iterator &other) const
         {
             return !(*this == other);
         }
 
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const combinations_iterator &other) const
+        {
+            return _M_its < other._M_its;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const combinations_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const combinations_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const combinations_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
     private:
-        Iterator _M_it;
-        Iterator _M_it_last;
-        combinations_iterator<N - 1, Iterator> _M_sub_it;
+        template <std::size_t... I>
+        decltype(auto) deref_impl(std::index_sequence<I...>) const
+        {
+            return std::tuple<decltype(*_M_its[I])...>(*_M_its[I]...);
+        }
+
+        std::array<Iterator, N> _M_its;
+        std::array<Iterator, N> _M_lasts;
     };
 
     template <std::size_t N, typename Iterator>
@@ -143,7 +347,7 @@ namespace itertools
         std::size_t length = std::distance(first, last);
         if (length < N)
         {
-            return range_view(comb_it_t(first, first), comb_it_t(first, first));
+            return range_view(comb_it_t(last), comb_it_t(last));
         }
         Iterator it = std::next(first, 1 + length - N);
         return range_view(comb_it_t(first, it), comb_it_t(it, it));
@@ -155,4 +359,214 @@ namespace itertools
         return combinations<N>(iterable.begin(), iterable.end());
     }
 
+    /// Same as combinations_iterator, with r known only at runtime.
+    ///
+    /// All state lives in one buffer of 2 * r iterators: the current combination,
+    /// followed by the (exclusive) last position each of its slots may take.
+    /// The buffer is allocated once on construction; operator++ never allocates.
+    ///
+    /// When Iterator is random access, the iterator can be moved by +=, except for the end iterator,
+    /// which has no buffer.
+    template <typename Iterator>
+    class dynamic_combinations_iterator
+    {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
+    public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = indirect_view<Iterator>;
+        using value_type = indirect_view<Iterator>;
+        using pointer = void;
+
+        /// \brief The end iterator.
+        dynamic_combinations_iterator() : _M_r(0), _M_done(true) {}
+
+        dynamic_combinations_iterator(Iterator first, Iterator last, std::size_t r)
+            : _M_r(r), _M_done(false)
+        {
+            std::size_t length = std::distance(first, last);
+            if (length < r)
+            {
+                _M_done = true;
+                return;
+            }
+            if (r == 0)
+            {
+                return;
+            }
+            _M_buf.reserve(2 * r);
+            Iterator slot_last = std::next(first, 1 + length - r);
+            for (std::size_t i = 0; i != r; ++i, ++first)
+            {
+                _M_buf.push_back(first);
+            }
+            for (std::size_t i = 0; i != r; ++i, ++slot_last)
+            {
+                _M_buf.push_back(slot_last);
+            }
+        }
+
+        /// \brief Number of combinations from this position to the end.
+        difference_type remaining() const
+        {
+            if (_M_done)
+            {
+                return 0;
+            }
+            return _M_r == 0 ? 1 : combinations_remaining(_M_buf.data(), _M_r, _M_buf.back());
+        }
+
+        /// \brief Move to the position that has n combinations remaining.
+        void seek(difference_type n)
+        {
+            _M_done = n == 0;
+            if (!_M_done && _M_r != 0)
+            {
+                combinations_seek(_M_buf.data(), _M_r, _M_buf.back(), n);
+            }
+        }
+
+        indirect_view<Iterator> operator*() const
+        {
+            return indirect_view<Iterator>(_M_buf.data(), _M_r);
+        }
+
+        dynamic_combinations_iterator &operator++()
+        {
+            _M_done = !next_combination(_M_buf.data(), _M_buf.data() + _M_r, _M_r);
+            return *this;
+        }
+
+        dynamic_combinations_iterator operator++(int)
+        {
+            dynamic_combinations_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        dynamic_combinations_iterator &operator+=(difference_type n)
+        {
+            seek(remaining() - n);
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        dynamic_combinations_iterator operator+(difference_type n) const
+        {
+            return dynamic_combinations_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend dynamic_combinations_iterator operator+(difference_type n, const dynamic_combinations_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const dynamic_combinations_iterator &other) const
+        {
+            return other.remaining() - remaining();
+        }
+
+        bool operator==(const dynamic_combinations_iterator &other) const
+        {
+            return _M_done == other._M_done && (_M_done || std::equal(_M_buf.begin(), _M_buf.begin() + _M_r, other._M_buf.begin()));
+        }
+
+        bool operator!=(const dynamic_combinations_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        std::vector<Iterator> _M_buf;
+        std::size_t _M_r;
+        bool _M_done;
+    };
+
+    template <typename Iterator>
+    class dynamic_combinations_impl : public view_base<dynamic_combinations_impl<Iterator>>
+    {
+    public:
+        dynamic_combinations_impl(Iterator first, Iterator last, std::size_t r)
+            : _M_it_first(first), _M_it_last(last), _M_r(r) {}
+
+        auto begin() const
+        {
+            return dynamic_combinations_iterator<Iterator>(_M_it_first, _M_it_last, _M_r);
+        }
+
+        auto end() const
+        {
+            return dynamic_combinations_iterator<Iterator>();
+        }
+
+        /// \brief Number of combinations, C(n, r).
+        std::size_t size() const
+        {
+            return binomial(std::distance(_M_it_first, _M_it_last), _M_r);
+        }
+
+    private:
+        Iterator _M_it_first;
+        Iterator _M_it_last;
+        std::size_t _M_r;
+    };
+
+    /// \brief Combinations of r elements, r being a runtime value.
+    ///
+    /// Each combination is an indirect_view of the selected elements.
+    /// It refers to the state of the iterator, and is invalidated when the iterator advances.
+    template <typename Iterator>
+    auto combinations(Iterator first, Iterator last, std::size_t r)
+    {
+        return dynamic_combinations_impl<Iterator>(first, last, r);
+    }
+
+    template <typename Iterable>
+    auto combinations(Iterable &&iterable, std::size_t r)
+    {
+        return combinations(iterable.begin(), iterable.end(), r);
+    }
+
+    /// \brief The index-th (0-based, lexicographic) combination of k elements of the iterable, as a vector of copies.
+    template <typename Iterable>
+    auto nth_combination(Iterable &&iterable, std::size_t k, std::size_t index)
+    {
+        auto it = iterable.begin();
+        std::size_t n = std::distance(it, iterable.end());
+        std::size_t total = binomial(n, k);
+        if (index >= total)
+        {
+            throw std::out_of_range("nth_combination() index out of range");
+        }
+        std::vector<std::decay_t<decltype(*it)>> result;
+        result.reserve(k);
+        std::size_t pos = 0;
+        combinadic(total - 1 - index, k, [&](std::size_t, std::size_t e) {
+            std::advance(it, n - 1 - e - pos);
+            pos = n - 1 - e;
+            result.push_back(*it);
+        });
+        return result;
+    }
+
+    /// \brief Lexicographic rank of the combination made of the elements at the (increasing) positions of the iterable.
+    template <typename Iterable, typename Positions>
+    std::size_t combination_rank(Iterable &&iterable, const Positions &positions)
+    {
+        std::size_t n = std::distance(iterable.begin(), iterable.end());
+        std::size_t k = std::distance(positions.begin(), positions.end());
+        std::size_t after = 0;
+        std::size_t i = 0;
+        for (auto pos : positions)
+        {
+            after += binomial(n - 1 - pos, k - i);
+            ++i;
+        }
+        return binomial(n, k) - 1 - after;
+    }
+
 } // namespace itertools
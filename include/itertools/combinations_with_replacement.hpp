@@ -29,120 +29,439 @@
 
 #pragma once
 
+#include <itertools/combinations.hpp>
+#include <itertools/indirect_view.hpp>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace itertools
 {
-    template <std::size_t N, typename Iterator>
-    class combinations_with_replacement_iterator;
+    // A combination with replacement a[0] <= a[1] <= ... <= a[r - 1] of n positions maps to the
+    // combination a[0] < a[1] + 1 < ... < a[r - 1] + r - 1 of n + r - 1 positions, which is ranked
+    // as in combinations.hpp: from the end, with f[i] = e[i] + r - 1 - i and e[i] = last - 1 - its[i].
+
+    /// \brief Number of combinations with replacement from its[0, r) (inclusive) to the end.
+    template <typename Iterator>
+    std::ptrdiff_t combinations_with_replacement_remaining(const Iterator *its, std::size_t r, Iterator last)
+    {
+        std::size_t n = 1;
+        for (std::size_t i = 0; i != r; ++i)
+        {
+            n += binomial(last - its[i] - 1 + (r - 1 - i), r - i);
+        }
+        return n;
+    }
+
+    /// \brief Set its[0, r) to the combination with replacement that has n combinations remaining; n > 0.
+    template <typename Iterator>
+    void combinations_with_replacement_seek(Iterator *its, std::size_t r, Iterator last, std::ptrdiff_t n)
+    {
+        combinadic(n - 1, r, [its, r, last](std::size_t i, std::size_t f) { its[i] = last - 1 - (f - (r - 1 - i)); });
+    }
 
-    // base case: N = 1, behaves much like "regular" iterator.
+    /// \brief Advance its[0, r) to the next combination with replacement.
+    ///
+    /// \return false if there is no next combination; then every slot is at last.
     template <typename Iterator>
-    class combinations_with_replacement_iterator<1, Iterator>
+    bool next_combination_with_replacement(Iterator *its, Iterator last, std::size_t r)
+    {
+        // find the rightmost slot that can still advance, then set the following slots to it
+        for (std::size_t i = r; i-- > 0;)
+        {
+            if (std::next(its[i]) != last)
+            {
+                ++its[i];
+                std::fill(its + i + 1, its + r, its[i]);
+                return true;
+            }
+        }
+        std::fill(its, its + r, last);
+        return false;
+    }
+
+    /// combinations_with_replacement_iterator keeps the N selected iterators, and the last input iterator.
+    ///
+    /// When Iterator is random access, so is combinations_with_replacement_iterator.
+    template <std::size_t N, typename Iterator>
+    class combinations_with_replacement_iterator
     {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
     public:
+        using iterator_category = view_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = tuple_of_n_t<decltype(*std::declval<const Iterator &>()), N>;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        combinations_with_replacement_iterator() = default;
+
         combinations_with_replacement_iterator(Iterator it, Iterator it_last)
-            : _M_it(it), _M_it_last(it_last) {}
+            : _M_it_last(it_last)
+        {
+            _M_its.fill(it);
+        }
 
-        void rewind(Iterator it)
+        /// \brief Number of combinations from this position to the end.
+        difference_type remaining() const
         {
-            _M_it = it;
+            return _M_its[0] == _M_it_last ? 0 : combinations_with_replacement_remaining(_M_its.data(), N, _M_it_last);
         }
 
-        bool exhausted() const { return _M_it == _M_it_last; }
+        /// \brief Move to the position that has n combinations remaining.
+        void seek(difference_type n)
+        {
+            if (n == 0)
+            {
+                _M_its.fill(_M_it_last);
+            }
+            else
+            {
+                combinations_with_replacement_seek(_M_its.data(), N, _M_it_last, n);
+            }
+        }
 
         decltype(auto) operator*() const
         {
-            return std::make_tuple(*_M_it);
+            return deref_impl(std::make_index_sequence<N>());
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        decltype(auto) operator[](difference_type n) const
+        {
+            return *(*this + n);
         }
 
         combinations_with_replacement_iterator &operator++()
         {
-            ++_M_it;
+            next_combination_with_replacement(_M_its.data(), _M_it_last, N);
             return *this;
         }
 
-        bool operator==(const combinations_with_replacement_iterator &other)
+        combinations_with_replacement_iterator operator++(int)
+        {
+            combinations_with_replacement_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator &operator--()
+        {
+            return *this -= 1;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator operator--(int)
         {
-            return _M_it == other._M_it;
+            combinations_with_replacement_iterator tmp = *this;
+            --*this;
+            return tmp;
         }
 
-        bool operator!=(const combinations_with_replacement_iterator &other)
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator &operator+=(difference_type n)
+        {
+            seek(remaining() - n);
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator &operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator operator+(difference_type n) const
+        {
+            return combinations_with_replacement_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend combinations_with_replacement_iterator operator+(difference_type n, const combinations_with_replacement_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        combinations_with_replacement_iterator operator-(difference_type n) const
+        {
+            return combinations_with_replacement_iterator(*this) -= n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const combinations_with_replacement_iterator &other) const
+        {
+            return other.remaining() - remaining();
+        }
+
+        bool operator==(const combinations_with_replacement_iterator &other) const
+        {
+            return _M_its == other._M_its;
+        }
+
+        bool operator!=(const combinations_with_replacement_iterator &other) const
         {
             return !(*this == other);
         }
 
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const combinations_with_replacement_iterator &other) const
+        {
+            return _M_its < other._M_its;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const combinations_with_replacement_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const combinations_with_replacement_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const combinations_with_replacement_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
     private:
-        Iterator _M_it;
+        template <std::size_t... I>
+        decltype(auto) deref_impl(std::index_sequence<I...>) const
+        {
+            return std::tuple<decltype(*_M_its[I])...>(*_M_its[I]...);
+        }
+
+        std::array<Iterator, N> _M_its;
         Iterator _M_it_last;
     };
 
     template <std::size_t N, typename Iterator>
-    class combinations_with_replacement_iterator
+    auto combinations_with_replacement(Iterator first, Iterator last)
     {
+        static_assert(N > 0);
+        using comb_it_t = combinations_with_replacement_iterator<N, Iterator>;
+        std::size_t length = std::distance(first, last);
+        if (length < N)
+        {
+            return range_view(comb_it_t(last, last), comb_it_t(last, last));
+        }
+        return range_view(comb_it_t(first, last), comb_it_t(last, last));
+    }
+
+    template <std::size_t N, typename Iterable>
+    auto combinations_with_replacement(Iterable &&iterable)
+    {
+        return combinations_with_replacement<N>(iterable.begin(), iterable.end());
+    }
+
+    /// Same as combinations_with_replacement_iterator, with r known only at runtime.
+    ///
+    /// The current combination lives in one buffer of r iterators, allocated once on construction;
+    /// operator++ never allocates.
+    ///
+    /// When Iterator is random access, the iterator can be moved by +=, except for the end iterator,
+    /// which has no buffer.
+    template <typename Iterator>
+    class dynamic_combinations_with_replacement_iterator
+    {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
     public:
-        combinations_with_replacement_iterator(Iterator it, Iterator it_last)
-            : _M_it(it), _M_it_last(it_last), _M_sub_it(it, it_last)
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = indirect_view<Iterator>;
+        using value_type = indirect_view<Iterator>;
+        using pointer = void;
+
+        /// \brief The end iterator.
+        dynamic_combinations_with_replacement_iterator() : _M_done(true) {}
+
+        dynamic_combinations_with_replacement_iterator(Iterator first, Iterator last, std::size_t r)
+            : _M_buf(r, first), _M_it_last(last), _M_done(false)
         {
+            std::size_t length = std::distance(first, last);
+            if (length < r)
+            {
+                _M_done = true;
+            }
         }
 
-        void rewind(Iterator it)
+        /// \brief Number of combinations from this position to the end.
+        difference_type remaining() const
         {
-            _M_it = it;
-            _M_sub_it.rewind(_M_it);
+            return _M_done ? 0 : combinations_with_replacement_remaining(_M_buf.data(), _M_buf.size(), _M_it_last);
         }
 
-        bool exhausted() const
+        /// \brief Move to the position that has n combinations remaining.
+        void seek(difference_type n)
         {
-            return _M_it == _M_it_last;
+            _M_done = n == 0;
+            if (!_M_done)
+            {
+                combinations_with_replacement_seek(_M_buf.data(), _M_buf.size(), _M_it_last, n);
+            }
         }
 
-        decltype(auto) operator*() const
+        indirect_view<Iterator> operator*() const
         {
-            return std::tuple_cat(std::make_tuple(*_M_it), *_M_sub_it);
+            return indirect_view<Iterator>(_M_buf.data(), _M_buf.size());
         }
 
-        combinations_with_replacement_iterator &operator++()
+        dynamic_combinations_with_replacement_iterator &operator++()
         {
-            if ((++_M_sub_it).exhausted())
-            {
-                ++_M_it;
-                _M_sub_it.rewind(_M_it);
-            }
+            _M_done = !next_combination_with_replacement(_M_buf.data(), _M_it_last, _M_buf.size());
             return *this;
         }
 
-        bool operator==(const combinations_with_replacement_iterator &other)
+        dynamic_combinations_with_replacement_iterator operator++(int)
+        {
+            dynamic_combinations_with_replacement_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        dynamic_combinations_with_replacement_iterator &operator+=(difference_type n)
+        {
+            seek(remaining() - n);
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        dynamic_combinations_with_replacement_iterator operator+(difference_type n) const
+        {
+            return dynamic_combinations_with_replacement_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend dynamic_combinations_with_replacement_iterator operator+(difference_type n, const dynamic_combinations_with_replacement_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const dynamic_combinations_with_replacement_iterator &other) const
         {
-            return _M_it == other._M_it && _M_sub_it == other._M_sub_it;
+            return other.remaining() - remaining();
         }
 
-        bool operator!=(const combinations_with_replacement_iterator &other)
+        bool operator==(const dynamic_combinations_with_replacement_iterator &other) const
+        {
+            return _M_done == other._M_done && (_M_done || _M_buf == other._M_buf);
+        }
+
+        bool operator!=(const dynamic_combinations_with_replacement_iterator &other) const
         {
             return !(*this == other);
         }
 
     private:
-        Iterator _M_it;
+        std::vector<Iterator> _M_buf;
         Iterator _M_it_last;
-        combinations_with_replacement_iterator<N - 1, Iterator> _M_sub_it;
+        bool _M_done;
     };
 
-    template <std::size_t N, typename Iterator>
-    auto combinations_with_replacement(Iterator first, Iterator last)
+    template <typename Iterator>
+    class dynamic_combinations_with_replacement_impl : public view_base<dynamic_combinations_with_replacement_impl<Iterator>>
     {
-        static_assert(N > 0);
-        using comb_it_t = combinations_with_replacement_iterator<N, Iterator>;
-        std::size_t length = std::distance(first, last);
-        if (length < N)
+    public:
+        dynamic_combinations_with_replacement_impl(Iterator first, Iterator last, std::size_t r)
+            : _M_it_first(first), _M_it_last(last), _M_r(r) {}
+
+        auto begin() const
         {
-            return range_view(comb_it_t(first, first), comb_it_t(first, first));
+            return dynamic_combinations_with_replacement_iterator<Iterator>(_M_it_first, _M_it_last, _M_r);
         }
-        return range_view(comb_it_t(first, last), comb_it_t(last, last));
+
+        auto end() const
+        {
+            return dynamic_combinations_with_replacement_iterator<Iterator>();
+        }
+
+        /// \brief Number of combinations with replacement, C(n + r - 1, r).
+        std::size_t size() const
+        {
+            std::size_t length = std::distance(_M_it_first, _M_it_last);
+            return length < _M_r ? 0 : binomial(length + _M_r - 1, _M_r);
+        }
+
+    private:
+        Iterator _M_it_first;
+        Iterator _M_it_last;
+        std::size_t _M_r;
+    };
+
+    /// \brief Combinations with replacement of r elements, r being a runtime value.
+    ///
+    /// Each combination is an indirect_view of the selected elements.
+    /// It refers to the state of the iterator, and is invalidated when the iterator advances.
+    template <typename Iterator>
+    auto combinations_with_replacement(Iterator first, Iterator last, std::size_t r)
+    {
+        return dynamic_combinations_with_replacement_impl<Iterator>(first, last, r);
+    }
+
+    template <typename Iterable>
+    auto combinations_with_replacement(Iterable &&iterable, std::size_t r)
+    {
+        return combinations_with_replacement(iterable.begin(), iterable.end(), r);
+    }
+
+    /// \brief The index-th (0-based, lexicographic) combination with replacement of k elements of the iterable,
+    /// as a vector of copies.
+    template <typename Iterable>
+    auto nth_combination_with_replacement(Iterable &&iterable, std::size_t k, std::size_t index)
+    {
+        auto it = iterable.begin();
+        std::size_t n = std::distance(it, iterable.end());
+        std::size_t total = (n == 0 && k != 0) ? 0 : binomial(n + k - 1, k);
+        if (index >= total)
+        {
+            throw std::out_of_range("nth_combination_with_replacement() index out of range");
+        }
+        std::vector<std::decay_t<decltype(*it)>> result;
+        result.reserve(k);
+        std::size_t pos = 0;
+        combinadic(total - 1 - index, k, [&](std::size_t i, std::size_t f) {
+            std::size_t e = f - (k - 1 - i);
+            std::advance(it, n - 1 - e - pos);
+            pos = n - 1 - e;
+            result.push_back(*it);
+        });
+        return result;
+    }
+
+    /// \brief Lexicographic rank of the combination with replacement made of the elements at the
+    /// (non-decreasing) positions of the iterable.
+    template <typename Iterable, typename Positions>
+    std::size_t combination_with_replacement_rank(Iterable &&iterable, const Positions &positions)
+    {
+        std::size_t n = std::distance(iterable.begin(), iterable.end());
+        std::size_t k = std::distance(positions.begin(), positions.end());
+        std::size_t after = 0;
+        std::size_t i = 0;
+        for (auto pos : positions)
+        {
+            after += binomial(n - 1 - pos + (k - 1 - i), k - i);
+            ++i;
+        }
+        return binomial(n + k - 1, k) - 1 - after;
     }
 
 } // namespace itertools
@@ -24,11 +24,30 @@
  * Make an iterator that filters elements from data returning only those that have a 
  * corresponding element in selectors that evaluates to True. 
  * Stops when either the data or selectors iterables has been exhausted.
+ *
+ * When the selectors are contiguous integers (pointers, std::vector) and the data has
+ * random access, the selectors are read 64 at a time into a bitmask, and the iterator jumps from
+ * one set bit to the next.
+ *
+ * Selectors already packed into bits (bitmask_view, std::bitset, std::vector<bool> passed as an
+ * iterable) are searched for the next set bit directly (see find_next_set()). A bitmask_view is copied
+ * into the iterators, as it is itself a view; a std::bitset or std::vector<bool> is referenced, so it
+ * must be an lvalue that outlives the view.
  */
 
 #pragma once
 
+#include <itertools/bitmask.hpp>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/splittable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace itertools
 {
@@ -36,6 +55,14 @@ namespace itertools
     class compress_iterator
     {
     public:
+        using iterator_category = forward_iterator_category_t<DIterator, SIterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const DIterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        compress_iterator() = default;
+
         compress_iterator(DIterator d_it, DIterator d_it_last, SIterator s_it, SIterator s_it_last)
             : _M_d_it(d_it), _M_d_it_last(d_it_last), _M_s_it(s_it), _M_s_it_last(s_it_last)
         {
@@ -61,6 +88,27 @@ namespace itertools
             return *this;
         }
 
+        compress_iterator operator++(int)
+        {
+            compress_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /// \brief Work is counted in positions of data and selectors, selected or not.
+        std::ptrdiff_t split_distance(const compress_iterator &other) const
+        {
+            return std::min(itertools::split_distance(_M_d_it, other._M_d_it), itertools::split_distance(_M_s_it, other._M_s_it));
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const compress_iterator &last)
+        {
+            std::ptrdiff_t k = itertools::split_advance(_M_s_it, itertools::split_advance(_M_d_it, n, last._M_d_it), last._M_s_it);
+            for (; _M_s_it != _M_s_it_last && _M_d_it != _M_d_it_last && !(*_M_s_it); ++_M_s_it, ++_M_d_it, ++k)
+                ;
+            return k;
+        }
+
         bool operator==(const compress_iterator &other) const
         {
             return _M_d_it == other._M_d_it || _M_s_it == other._M_s_it;
@@ -78,11 +126,238 @@ namespace itertools
         SIterator _M_s_it_last;
     };
 
+    template <typename DIterator, typename SIterator>
+    class blocked_compress_iterator
+    {
+    public:
+        using iterator_category = forward_iterator_category_t<DIterator, SIterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const DIterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        blocked_compress_iterator() = default;
+
+        blocked_compress_iterator(DIterator d_it, DIterator d_it_last, SIterator s_it, SIterator s_it_last)
+            : _M_d_it(d_it), _M_s_it(s_it),
+              _M_d_block(d_it), _M_s_block(s_it),
+              _M_s_last(s_it + std::min<std::ptrdiff_t>(d_it_last - d_it, s_it_last - s_it)),
+              _M_mask(scan())
+        {
+            next_selected();
+        }
+
+        void next_selected()
+        {
+            while (_M_mask == 0)
+            {
+                if (_M_s_last - _M_s_block <= 64)
+                {
+                    _M_d_it = _M_d_block + (_M_s_last - _M_s_block);
+                    _M_s_it = _M_s_last;
+                    return;
+                }
+                _M_d_block += 64;
+                _M_s_block += 64;
+                _M_mask = scan();
+            }
+            int i = countr_zero(_M_mask);
+            _M_mask &= _M_mask - 1;
+            _M_d_it = _M_d_block + i;
+            _M_s_it = _M_s_block + i;
+        }
+
+        decltype(auto) operator*() const
+        {
+            return *_M_d_it;
+        }
+
+        blocked_compress_iterator &operator++()
+        {
+            next_selected();
+            return *this;
+        }
+
+        blocked_compress_iterator operator++(int)
+        {
+            blocked_compress_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        std::ptrdiff_t split_distance(const blocked_compress_iterator &other) const
+        {
+            return std::min(other._M_d_it - _M_d_it, other._M_s_it - _M_s_it);
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const blocked_compress_iterator &last)
+        {
+            SIterator s_first = _M_s_it;
+            n = std::min(n, split_distance(last));
+            _M_d_block = _M_d_it + n;
+            _M_s_block = _M_s_it + n;
+            _M_mask = scan();
+            next_selected();
+            return _M_s_it - s_first;
+        }
+
+        bool operator==(const blocked_compress_iterator &other) const
+        {
+            return _M_d_it == other._M_d_it || _M_s_it == other._M_s_it;
+        }
+
+        bool operator!=(const blocked_compress_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        std::uint64_t scan() const
+        {
+            auto n = std::min<std::ptrdiff_t>(_M_s_last - _M_s_block, 64);
+            return n == 0 ? 0 : nonzero_mask(&*_M_s_block, n);
+        }
+
+        DIterator _M_d_it;
+        SIterator _M_s_it;
+        DIterator _M_d_block;
+        SIterator _M_s_block;
+        SIterator _M_s_last; // where data or selectors run out
+        std::uint64_t _M_mask; // selected elements of the block after _M_s_it
+    };
+
+    /// \brief The iterator used by compress() over DIterator and SIterator.
+    template <typename DIterator, typename SIterator>
+    using compress_iterator_t = std::conditional_t<is_blockable_iterator<SIterator>() && is_subtractable<DIterator>::value,
+                                                   blocked_compress_iterator<DIterator, SIterator>,
+                                                   compress_iterator<DIterator, SIterator>>;
+
+    /// \brief How packed_compress_iterator holds its mask: a pointer to it, or a copy of a bitmask_view.
+    template <typename Bits>
+    struct packed_mask_ref
+    {
+        using type = const Bits *;
+
+        static type make(const Bits &bits) { return &bits; }
+
+        static const Bits &get(type bits) { return *bits; }
+    };
+
+    template <>
+    struct packed_mask_ref<bitmask_view>
+    {
+        using type = bitmask_view;
+
+        static type make(const bitmask_view &bits) { return bits; }
+
+        static const bitmask_view &get(const type &bits) { return bits; }
+    };
+
+    template <typename DIterator, typename Bits>
+    class packed_compress_iterator
+    {
+    public:
+        using iterator_category = forward_iterator_category_t<DIterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const DIterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        packed_compress_iterator() = default;
+
+        packed_compress_iterator(DIterator d_it, DIterator d_it_last, const Bits &bits, std::size_t pos)
+            : _M_d_it(d_it), _M_d_it_last(d_it_last), _M_bits(packed_mask_ref<Bits>::make(bits)), _M_pos(pos)
+        {
+            seek(pos);
+        }
+
+        decltype(auto) operator*() const
+        {
+            return *_M_d_it;
+        }
+
+        packed_compress_iterator &operator++()
+        {
+            seek(_M_pos + 1);
+            return *this;
+        }
+
+        packed_compress_iterator operator++(int)
+        {
+            packed_compress_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        std::ptrdiff_t split_distance(const packed_compress_iterator &other) const
+        {
+            return std::min<std::ptrdiff_t>(other._M_pos - _M_pos, itertools::split_distance(_M_d_it, other._M_d_it));
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const packed_compress_iterator &last)
+        {
+            std::size_t first = _M_pos;
+            seek(_M_pos + std::min(n, split_distance(last)));
+            return _M_pos - first;
+        }
+
+        bool operator==(const packed_compress_iterator &other) const
+        {
+            return _M_pos == other._M_pos;
+        }
+
+        bool operator!=(const packed_compress_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        /// \brief Move to the first selected element at or after pos; past the end, pos is the size of the mask.
+        void seek(std::size_t pos)
+        {
+            const Bits &bits = packed_mask_ref<Bits>::get(_M_bits);
+            std::size_t size = bits.size();
+            pos = find_next_set(bits, pos);
+            if (pos != size)
+            {
+                std::ptrdiff_t gap = pos - _M_pos;
+                if (itertools::split_advance(_M_d_it, gap, _M_d_it_last) == gap && _M_d_it != _M_d_it_last)
+                {
+                    _M_pos = pos;
+                    return;
+                }
+            }
+            // out of selectors or of data
+            _M_d_it = _M_d_it_last;
+            _M_pos = size;
+        }
+
+        DIterator _M_d_it;
+        DIterator _M_d_it_last;
+        typename packed_mask_ref<Bits>::type _M_bits{};
+        std::size_t _M_pos = 0;
+    };
+
+    /// \brief Filter data with a packed mask: a bitmask_view, a std::bitset or a std::vector<bool>.
+    ///
+    /// A bitmask_view is copied; a std::bitset or std::vector<bool> is referenced, not copied, and must
+    /// outlive the view.
+    template <typename DIterator, typename Bits>
+    auto compress_bits(DIterator data_first, DIterator data_last, const Bits &bits)
+    {
+        using it_t = packed_compress_iterator<DIterator, Bits>;
+        return range_view<it_t>(it_t(data_first, data_last, bits, 0), it_t(data_last, data_last, bits, bits.size()));
+    }
+
+    /// \brief A temporary std::bitset or std::vector<bool> would be destroyed before the view is used.
+    template <typename DIterator, typename Bits, typename = std::enable_if_t<!std::is_same_v<Bits, bitmask_view>>>
+    auto compress_bits(DIterator data_first, DIterator data_last, const Bits &&bits) = delete;
+
     template <typename DIterator, typename SIterator>
     auto compress(DIterator data_first, DIterator data_last,
                   SIterator selector_first, SIterator selector_last)
     {
-        using it_t = compress_iterator<DIterator, SIterator>;
+        using it_t = compress_iterator_t<DIterator, SIterator>;
         it_t it_first(data_first, data_last, selector_first, selector_last);
         it_t it_last(data_last, data_last, selector_last, selector_last);
         return range_view<it_t>(it_first, it_last);
@@ -91,7 +366,14 @@ namespace itertools
     template <typename DIterable, typename SIterable>
     auto compress(DIterable &&data, SIterable &&selectors)
     {
-        return compress(data.begin(), data.end(), selectors.begin(), selectors.end());
+        if constexpr (is_packed_bitmask<std::decay_t<SIterable>>::value)
+        {
+            return compress_bits(data.begin(), data.end(), std::forward<SIterable>(selectors));
+        }
+        else
+        {
+            return compress(data.begin(), data.end(), selectors.begin(), selectors.end());
+        }
     }
 
 } // namespace itertools
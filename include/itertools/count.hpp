@@ -22,11 +22,18 @@
  * @file count.hpp
  *
  * An infinite counter.
+ *
+ * Its end is unreachable_sentinel, so loops over it have no end test.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+
+#include <cstddef>
+#include <iterator>
 
 namespace itertools
 {
@@ -34,6 +41,14 @@ namespace itertools
     class count_iterator
     {
     public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = T;
+        using value_type = T;
+        using pointer = void;
+
+        count_iterator() = default;
+
         count_iterator(T start, S step)
             : _M_start(start), _M_step(step)
         {
@@ -50,9 +65,16 @@ namespace itertools
             return *this;
         }
 
+        count_iterator operator++(int)
+        {
+            count_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const count_iterator &other) const
         {
-            return false;
+            return _M_start == other._M_start;
         }
 
         bool operator!=(const count_iterator &other) const
@@ -61,15 +83,15 @@ namespace itertools
         }
 
     private:
-        T _M_start;
-        S _M_step;
+        T _M_start{};
+        S _M_step{};
     };
 
     template <typename T, typename S>
     auto count(T start, S step)
     {
         using c_it_t = count_iterator<T, S>;
-        return range_view<c_it_t>(c_it_t(start, step), c_it_t(start, step));
+        return range_view<c_it_t, unreachable_sentinel_t>(c_it_t(start, step), unreachable_sentinel);
     }
 
 } // namespace itertools
@@ -23,11 +23,17 @@
  *
  * Return elements from the iterable until it is exhausted.
  * Then repeat the sequence indefinitely.
+ *
+ * Its end is unreachable_sentinel, so loops over it have no end test.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+
+#include <cstddef>
 
 namespace itertools
 {
@@ -35,6 +41,14 @@ namespace itertools
     class cycle_iterator
     {
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        cycle_iterator() = default;
+
         cycle_iterator(Iterator first, Iterator last)
             : _M_it(first), _M_first(first), _M_last(last)
         {
@@ -54,9 +68,16 @@ namespace itertools
             return *this;
         }
 
+        cycle_iterator operator++(int)
+        {
+            cycle_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const cycle_iterator &other) const
         {
-            return false;
+            return _M_it == other._M_it;
         }
 
         bool operator!=(const cycle_iterator &other) const
@@ -74,13 +95,13 @@ namespace itertools
     auto cycle(Iterator first, Iterator last)
     {
         using c_it_t = cycle_iterator<Iterator>;
-        return range_view<c_it_t>(c_it_t(first, last), c_it_t(last, last));
+        return range_view<c_it_t, unreachable_sentinel_t>(c_it_t(first, last), unreachable_sentinel);
     }
 
     template <typename Iterable>
     auto cycle(Iterable &&iterable)
     {
-        return cycle(iterable.begin(), iterable.end());
+        return cycle(common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
 
 namespace itertools
 {
@@ -45,7 +46,7 @@ namespace itertools
     template <typename Fn, typename Iterable>
     auto dropwhile(Fn predicate, Iterable &&iterable)
     {
-        return dropwhile(predicate, iterable.begin(), iterable.end());
+        return dropwhile(predicate, common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
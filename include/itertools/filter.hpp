@@ -23,11 +23,23 @@
  *
  * Return an iterator yielding those items of iterable for which function(item)
  * is true. If function is None, return the items that are true.
+ *
+ * filter_blocked() evaluates the predicate on blocks of 64 elements at a time, ahead of the iteration,
+ * over contiguous integers (pointers, std::vector); it is only for predicates without side effects.
+ * filter() does the same when no predicate is given, since testing the truth of an element has none.
  */
 
 #pragma once
 
+#include <itertools/bitmask.hpp>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace itertools
 {
@@ -35,6 +47,14 @@ namespace itertools
     class filter_iterator
     {
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        filter_iterator() = default;
+
         filter_iterator(Fn fn, Iterator it, Iterator last)
             : _M_predicate(fn), _M_it(it), _M_last(last)
         {
@@ -59,6 +79,13 @@ namespace itertools
             return *this;
         }
 
+        filter_iterator operator++(int)
+        {
+            filter_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const filter_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -70,11 +97,95 @@ namespace itertools
         }
 
     private:
-        Fn _M_predicate;
+        copyable_box<Fn> _M_predicate;
+        Iterator _M_it;
+        Iterator _M_last;
+    };
+
+    /// \brief Filter over contiguous integers: the predicate is evaluated into a 64-bit mask per
+    /// block, and the selected elements are found from the set bits.
+    template <typename Fn, typename Iterator>
+    class blocked_filter_iterator
+    {
+    public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        blocked_filter_iterator() = default;
+
+        blocked_filter_iterator(Fn fn, Iterator it, Iterator last)
+            : _M_predicate(fn), _M_it(it), _M_block(it), _M_last(last), _M_mask(scan(it))
+        {
+            next_selected();
+        }
+
+        void next_selected()
+        {
+            while (_M_mask == 0)
+            {
+                if (_M_last - _M_block <= 64)
+                {
+                    _M_it = _M_last;
+                    return;
+                }
+                _M_block += 64;
+                _M_mask = scan(_M_block);
+            }
+            _M_it = _M_block + countr_zero(_M_mask);
+            _M_mask &= _M_mask - 1;
+        }
+
+        decltype(auto) operator*() const
+        {
+            return *_M_it;
+        }
+
+        blocked_filter_iterator &operator++()
+        {
+            next_selected();
+            return *this;
+        }
+
+        blocked_filter_iterator operator++(int)
+        {
+            blocked_filter_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const blocked_filter_iterator &other) const
+        {
+            return _M_it == other._M_it;
+        }
+
+        bool operator!=(const blocked_filter_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        std::uint64_t scan(Iterator block)
+        {
+            auto n = std::min<std::ptrdiff_t>(_M_last - block, 64);
+            return n == 0 ? 0 : predicate_mask(&*block, n, _M_predicate);
+        }
+
+        copyable_box<Fn> _M_predicate;
         Iterator _M_it;
+        Iterator _M_block;
         Iterator _M_last;
+        std::uint64_t _M_mask = 0; // elements of the block after _M_it that are selected
     };
 
+    /// \brief The iterator used by filter_blocked() over Iterator: blocked when the data is contiguous integers.
+    template <typename Fn, typename Iterator>
+    using filter_blocked_iterator_t = std::conditional_t<is_blockable_iterator<Iterator>(),
+                                                         blocked_filter_iterator<Fn, Iterator>,
+                                                         filter_iterator<Fn, Iterator>>;
+
     template <typename T>
     struct boolean_transformer
     {
@@ -91,19 +202,34 @@ namespace itertools
     template <typename Fn, typename Iterable>
     auto filter(Fn predicate, Iterable &&iterable)
     {
-        return filter(predicate, iterable.begin(), iterable.end());
+        return filter(predicate, common_begin(iterable), common_end(iterable));
+    }
+
+    /// \brief Same as filter(), but the predicate may be evaluated up to 64 elements ahead of the iteration,
+    /// and on elements past the last one read; it must have no side effects.
+    template <typename Fn, typename Iterator>
+    auto filter_blocked(Fn predicate, Iterator first, Iterator last)
+    {
+        using it_t = filter_blocked_iterator_t<Fn, Iterator>;
+        return range_view<it_t>(it_t(predicate, first, last), it_t(predicate, last, last));
+    }
+
+    template <typename Fn, typename Iterable>
+    auto filter_blocked(Fn predicate, Iterable &&iterable)
+    {
+        return filter_blocked(predicate, common_begin(iterable), common_end(iterable));
     }
 
     template <typename Iterator>
     auto filter(Iterator first, Iterator last)
     {
-        return filter(boolean_transformer<decltype(*first)>(), first, last);
+        return filter_blocked(boolean_transformer<decltype(*first)>(), first, last);
     }
 
     template <typename Iterable>
     auto filter(Iterable &&iterable)
     {
-        return filter(iterable.begin(), iterable.end());
+        return filter(common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
@@ -28,33 +28,38 @@
 #pragma once
 
 #include <itertools/filter.hpp>
+#include <itertools/sentinel.hpp>
 
 namespace itertools
 {
+    template <typename T, typename Fn>
+    auto reverse_predicate(Fn predicate)
+    {
+        return [predicate](const T &arg) mutable { return predicate(arg) ? false : true; };
+    }
+
     template <typename Fn, typename Iterator>
     auto filterfalse(Fn predicate, Iterator first, Iterator last)
     {
-        using value_type = decltype(*first);
-        auto reverse_predicate = [&predicate](const value_type &arg) { return predicate(arg) ? false : true; };
-        using it_t = filter_iterator<decltype(reverse_predicate), Iterator>;
-        return range_view<it_t>(it_t(reverse_predicate, first, last), it_t(reverse_predicate, last, last));
+        return filter(reverse_predicate<decltype(*first)>(predicate), first, last);
     }
 
     template <typename Fn, typename Iterable>
     auto filterfalse(Fn predicate, Iterable &&iterable)
     {
-        return filterfalse(predicate, iterable.begin(), iterable.end());
+        return filterfalse(predicate, common_begin(iterable), common_end(iterable));
     }
 
+    /// \brief The items that are false; testing them has no side effects, so this is blocked like filter().
     template <typename Iterator>
     auto filterfalse(Iterator first, Iterator last)
     {
-        return filterfalse(boolean_transformer<decltype(*first)>(), first, last);
+        return filter_blocked(reverse_predicate<decltype(*first)>(boolean_transformer<decltype(*first)>()), first, last);
     }
 
     template <typename Iterable>
     auto filterfalse(Iterable &&iterable)
     {
-        return filterfalse(iterable.begin(), iterable.end());
+        return filterfalse(common_begin(iterable), common_end(iterable));
     }
 } // namespace itertools
@@ -36,31 +36,77 @@
  *
  * The returned group is itself an iterator that shares the underlying iterable with groupby().
  * Because the source is shared, when the groupby() object is advanced, the previous group is no longer visible. 
+ *
+ * When the key function returns a reference into the element, the key is returned by that reference and
+ * not copied at all; otherwise it is returned by value. Pass assume_sorted when the input is sorted on the key, so that the end of each
+ * group can be found by galloping over random access input; with the parallel policy as well, the groups
+ * are found on a thread pool and returned in a vector, or passed to a callback by for_each_group.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
+#include <itertools/parallel.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace itertools
 {
-    template <typename Iterator, typename Fn>
+    /// \brief Tag telling groupby that the input is sorted on the key, so that equal keys are never apart.
+    struct assume_sorted_t
+    {
+    };
+
+    inline constexpr assume_sorted_t assume_sorted{};
+
+    /// groupby_iterator keeps a pointer to the key instead of a copy when Fn returns a reference into the
+    /// element, e.g. to a member, and the elements are references into the iterable themselves.
+    ///
+    /// With Gallop, which needs iterators that can be subtracted and sorted input, the end of a group is found by
+    /// exponential then binary search, in O(log n) key computations for a group of n elements.
+    template <typename Iterator, typename Fn, bool Gallop = false>
     class groupby_iterator
     {
+        using result_t = std::invoke_result_t<Fn &, decltype(*std::declval<Iterator &>())>;
+
+        static constexpr bool by_reference = std::is_lvalue_reference_v<result_t> &&
+                                             std::is_lvalue_reference_v<decltype(*std::declval<Iterator &>())>;
+
         // return type of Fn
-        using key_t = typename std::remove_reference<typename std::invoke_result<Fn, decltype(*Iterator())>::type>::type;
+        using key_t = std::remove_cv_t<std::remove_reference_t<result_t>>;
+
+        using key_storage_t = std::conditional_t<by_reference, const key_t *, key_t>;
 
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        /// \brief The key by reference when it lives in the element, else by value, since the copy the iterator
+        /// keeps is overwritten by the next group.
+        using reference = std::tuple<std::conditional_t<by_reference, const key_t &, key_t>, range_view<Iterator>>;
+        using value_type = std::tuple<key_t, range_view<Iterator>>;
+        using pointer = void;
+
+        /// \brief A group kept apart from the iterator.
+        using group_type = reference;
+
+        groupby_iterator() = default;
+
         groupby_iterator(Iterator first, Iterator last, Fn key_fn)
             : _M_it(first), _M_it_last(last), _M_group_it_first(first), _M_key_fn(key_fn)
         {
             // compute initial key and group
             if (_M_it != _M_it_last)
             {
-                _M_key = _M_key_fn(*_M_it);
+                set_key();
                 ++_M_it; // so don't repeat computing key on the same element (first)
                 next_group();
             }
@@ -69,24 +115,79 @@ namespace itertools
         /// \brief Advance _M_it until _M_key_fn(*_M_it) yields a different key, or _M_it reaches last.
         void next_group()
         {
-            for (; _M_it != _M_it_last && (_M_next_key = _M_key_fn(*_M_it)) == _M_key; ++_M_it)
-                ;
+            if constexpr (Gallop)
+            {
+                // [_M_it, _M_it + lo) are in the group, and hi is the end of the group or last
+                std::ptrdiff_t lo = 0, hi = _M_it_last - _M_it;
+                for (std::ptrdiff_t step = 1; lo < hi; step *= 2)
+                {
+                    std::ptrdiff_t probe = std::min(lo + step, hi) - 1;
+                    if (!same_key(probe))
+                    {
+                        hi = probe;
+                        break;
+                    }
+                    lo = probe + 1;
+                }
+                while (lo < hi)
+                {
+                    std::ptrdiff_t mid = lo + (hi - lo) / 2;
+                    if (same_key(mid))
+                    {
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+                _M_it += lo;
+            }
+            else if constexpr (by_reference)
+            {
+                for (; _M_it != _M_it_last && same_key(_M_it); ++_M_it)
+                    ;
+            }
+            else
+            {
+                for (; _M_it != _M_it_last && (_M_next_key = _M_key_fn(*_M_it)) == _M_key; ++_M_it)
+                    ;
+            }
         }
 
-        decltype(auto) operator*() const
+        /// \brief The key and the group.
+        reference operator*() const
         {
-            return std::make_tuple(_M_key, range_view(_M_group_it_first, _M_it));
+            return {key(), range_view(_M_group_it_first, _M_it)};
         }
 
         groupby_iterator &operator++()
         {
             _M_group_it_first = _M_it;
-            _M_key = _M_next_key;
+            if (_M_it == _M_it_last)
+            {
+                return *this;
+            }
+            if constexpr (by_reference || Gallop)
+            {
+                set_key();
+            }
+            else
+            {
+                _M_key = std::move(_M_next_key);
+            }
             ++_M_it; // so don't repeat computing key on the same element
             next_group();
             return *this;
         }
 
+        groupby_iterator operator++(int)
+        {
+            groupby_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const groupby_iterator &other) const
         {
             return _M_group_it_first == other._M_group_it_first;
@@ -98,12 +199,49 @@ namespace itertools
         }
 
     private:
+        const key_t &key() const
+        {
+            if constexpr (by_reference)
+            {
+                return *_M_key;
+            }
+            else
+            {
+                return _M_key;
+            }
+        }
+
+        /// \brief Compute the key of the group starting at _M_it.
+        void set_key()
+        {
+            if constexpr (by_reference)
+            {
+                _M_key = &_M_key_fn(*_M_it);
+            }
+            else
+            {
+                _M_key = _M_key_fn(*_M_it);
+            }
+        }
+
+        bool same_key(const Iterator &it)
+        {
+            return _M_key_fn(*it) == key();
+        }
+
+        bool same_key(std::ptrdiff_t n)
+        {
+            Iterator it = _M_it;
+            it += n;
+            return same_key(it);
+        }
+
         Iterator _M_it; ///< _M_group_it_last
         Iterator _M_it_last;
         Iterator _M_group_it_first;
-        Fn _M_key_fn;
-        key_t _M_key;
-        key_t _M_next_key; ///< should always equal to _M_key_fn(*_M_it)
+        copyable_box<Fn> _M_key_fn;
+        key_storage_t _M_key{};
+        key_storage_t _M_next_key{}; ///< should always equal to _M_key_fn(*_M_it), only when not by_reference
     };
 
     template <typename T>
@@ -119,6 +257,14 @@ namespace itertools
         return range_view<it_t>(it_t(first, last, fn), it_t(last, last, fn));
     }
 
+    /// \brief groupby over input sorted on the key; groups are found by galloping for iterators that can be subtracted.
+    template <typename Iterator, typename Fn>
+    auto groupby(Iterator first, Iterator last, Fn fn, assume_sorted_t)
+    {
+        using it_t = groupby_iterator<Iterator, Fn, is_subtractable<Iterator>::value>;
+        return range_view<it_t>(it_t(first, last, fn), it_t(last, last, fn));
+    }
+
     template <typename Iterator>
     auto groupby(Iterator first, Iterator last)
     {
@@ -129,13 +275,101 @@ namespace itertools
     template <typename Iterable, typename Fn>
     auto groupby(Iterable &&iterable, Fn fn)
     {
-        return groupby(iterable.begin(), iterable.end(), fn);
+        return groupby(common_begin(iterable), common_end(iterable), fn);
+    }
+
+    template <typename Iterable, typename Fn>
+    auto groupby(Iterable &&iterable, Fn fn, assume_sorted_t)
+    {
+        return groupby(common_begin(iterable), common_end(iterable), fn, assume_sorted);
+    }
+
+    /// \brief All the groups of input sorted on the key, found in parallel: every chunk of the input is
+    /// grouped by galloping, and the groups cut by the edges of the chunks are joined.
+    template <typename Iterator, typename Fn>
+    auto groupby(Iterator first, Iterator last, Fn fn, assume_sorted_t, parallel::parallel_policy policy)
+    {
+        static_assert(is_subtractable<Iterator>::value, "parallel groupby needs random access iterators");
+
+        using it_t = groupby_iterator<Iterator, Fn, true>;
+        using group_t = typename it_t::group_type;
+        parallel::thread_pool &pool = policy.pool();
+        std::size_t n = itertools::split_distance(first, last);
+        auto views = chunk(range_view<Iterator>(first, last), parallel::chunk_count(n, pool.size(), 1 << 14));
+
+        std::vector<std::vector<group_t>> partials(views.size());
+        parallel::parallel_chunks(pool, views.size(), [&](std::size_t c) {
+            for (auto &&[k, g] : groupby(views[c].begin(), views[c].end(), fn, assume_sorted))
+            {
+                partials[c].emplace_back(k, g);
+            }
+        });
+
+        std::vector<group_t> groups;
+        for (auto &partial : partials)
+        {
+            for (auto &group : partial)
+            {
+                // a group that starts a chunk continues the last one if their keys are equal
+                if (!groups.empty() && std::get<1>(groups.back()).end() == std::get<1>(group).begin() &&
+                    std::get<0>(groups.back()) == std::get<0>(group))
+                {
+                    Iterator begin = std::get<1>(groups.back()).begin();
+                    group_t joined(std::move(std::get<0>(groups.back())), range_view<Iterator>(begin, std::get<1>(group).end()));
+                    groups.pop_back();
+                    groups.push_back(std::move(joined));
+                }
+                else
+                {
+                    groups.push_back(std::move(group));
+                }
+            }
+        }
+        return groups;
+    }
+
+    template <typename Iterable, typename Fn>
+    auto groupby(Iterable &&iterable, Fn fn, assume_sorted_t, parallel::parallel_policy policy)
+    {
+        return groupby(iterable.begin(), iterable.end(), fn, assume_sorted, policy);
+    }
+
+    /// \brief Call body(key, group) for every group of input sorted on the key. The groups are found as by
+    /// the parallel groupby, and body is called concurrently, once per group, in no particular order.
+    template <typename Iterator, typename Fn, typename Body>
+    void for_each_group(Iterator first, Iterator last, Fn fn, Body body, assume_sorted_t, parallel::parallel_policy policy)
+    {
+        auto groups = groupby(first, last, fn, assume_sorted, policy);
+        parallel::thread_pool &pool = policy.pool();
+        auto views = chunk(range_view(groups.begin(), groups.end()), parallel::chunk_count(groups.size(), pool.size(), 16));
+        parallel::parallel_chunks(pool, views.size(), [&](std::size_t c) {
+            for (auto &[k, g] : views[c])
+            {
+                body(k, g);
+            }
+        });
+    }
+
+    template <typename Iterable, typename Fn, typename Body>
+    void for_each_group(Iterable &&iterable, Fn fn, Body body, assume_sorted_t, parallel::parallel_policy policy)
+    {
+        for_each_group(iterable.begin(), iterable.end(), fn, body, assume_sorted, policy);
     }
 
     template <typename Iterable>
     auto groupby(Iterable &&iterable)
     {
-        return groupby(iterable.begin(), iterable.end());
+        return groupby(common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
+
+#if defined(__cpp_lib_ranges)
+/// \brief A group and its value have a common reference, which std::indirectly_readable asks for, and which
+/// std::tuple only provides from C++23 on.
+template <typename Key1, typename Key2, typename Iterator, template <typename> class TQual, template <typename> class UQual>
+struct std::basic_common_reference<std::tuple<Key1, itertools::range_view<Iterator>>, std::tuple<Key2, itertools::range_view<Iterator>>, TQual, UQual>
+{
+    using type = std::tuple<std::common_reference_t<TQual<Key1>, UQual<Key2>>, itertools::range_view<Iterator>>;
+};
+#endif
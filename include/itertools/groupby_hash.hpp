@@ -0,0 +1,293 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file groupby_hash.hpp
+ *
+ * Aggregate the elements of an iterable by key, like SQL's GROUP BY, in a single pass.
+ *
+ * groupby_hash([1, 2, 1, 3, 2, 1], identity, 0, plus) -> (1, 3), (2, 4), (3, 3)
+ *
+ * Unlike groupby(), the input does not need to be sorted: every element is folded into the aggregate of
+ * its key, which is looked up in an open-addressing hash table. The aggregates are stored contiguously,
+ * in the order their keys first appear in the input, and the table only holds their indices.
+ *
+ * With the parallel policy, the input is cut into one chunk per worker, every chunk is aggregated into a
+ * table of its own, and the tables are merged in order with merge(Acc, Acc), so the result is the same as
+ * the sequential one when merge is associative. merge must always be given: agg folds in elements, and
+ * reusing it on two aggregates is only right when they have the element type, e.g. not for counts.
+ * Every chunk starts its aggregates from init, so init must be an identity of merge (0 for a sum, an
+ * empty vector for a concatenation); when Acc can be compared and merge(init, init) != init, as for a
+ * sum from 10, the input is aggregated sequentially instead.
+ */
+
+#pragma once
+
+#include <itertools/parallel.hpp>
+#include <itertools/range_view.hpp>
+#include <itertools/splittable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace itertools
+{
+    /// \brief Aggregates of type Acc by key of type Key, in the order the keys were inserted.
+    ///
+    /// As in std::unordered_map, the keys are const: only the aggregates may be modified.
+    template <typename Key, typename Acc, typename Hash = std::hash<Key>>
+    class hash_groups
+    {
+    public:
+        using value_type = std::pair<const Key, Acc>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        hash_groups() = default;
+
+        iterator begin() { return _M_entries.begin(); }
+
+        iterator end() { return _M_entries.end(); }
+
+        const_iterator begin() const { return _M_entries.begin(); }
+
+        const_iterator end() const { return _M_entries.end(); }
+
+        std::size_t size() const { return _M_entries.size(); }
+
+        /// \brief The group of key, or end().
+        const_iterator find(const Key &key) const
+        {
+            if (_M_entries.empty())
+            {
+                return end();
+            }
+            std::size_t h = hash(key);
+            for (std::size_t s = h & _M_mask;; s = (s + 1) & _M_mask)
+            {
+                const slot_t &slot = _M_slots[s];
+                if (slot.index == 0)
+                {
+                    return end();
+                }
+                if (slot.hash == h && _M_entries[slot.index - 1].first == key)
+                {
+                    return begin() + (slot.index - 1);
+                }
+            }
+        }
+
+        /// \brief The aggregate of key, inserted as a copy of init if key is new.
+        ///
+        /// The key is copied (or moved) only when it is inserted.
+        template <typename K>
+        Acc &find_or_insert(K &&key, const Acc &init)
+        {
+            if (2 * (_M_entries.size() + 1) > _M_slots.size())
+            {
+                rehash(_M_slots.empty() ? 16 : 2 * _M_slots.size());
+            }
+            std::size_t h = hash(key);
+            std::size_t s = h & _M_mask;
+            for (;; s = (s + 1) & _M_mask)
+            {
+                slot_t &slot = _M_slots[s];
+                if (slot.index == 0)
+                {
+                    break;
+                }
+                if (slot.hash == h && _M_entries[slot.index - 1].first == key)
+                {
+                    return _M_entries[slot.index - 1].second;
+                }
+            }
+            _M_entries.emplace_back(std::forward<K>(key), init);
+            _M_slots[s] = slot_t{h, _M_entries.size()};
+            return _M_entries.back().second;
+        }
+
+        /// \brief Fold the groups of other into this one with merge(Acc, Acc); new keys are appended in the
+        /// order of other.
+        template <typename Merge>
+        void merge(hash_groups &&other, Merge merge)
+        {
+            for (auto &entry : other._M_entries)
+            {
+                std::size_t n = _M_entries.size();
+                Acc &acc = find_or_insert(entry.first, entry.second);
+                if (_M_entries.size() == n)
+                {
+                    acc = merge(std::move(acc), std::move(entry.second));
+                }
+            }
+        }
+
+    private:
+        struct slot_t
+        {
+            std::size_t hash;
+            std::size_t index; ///< 1 + index of the entry, or 0 for an empty slot
+        };
+
+        /// \brief Hash of key, mixed so that the low bits used for the slot depend on all bits of std::hash,
+        /// which is the identity for integers.
+        template <typename K>
+        std::size_t hash(const K &key) const
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(Hash()(key));
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return static_cast<std::size_t>(h);
+        }
+
+        void rehash(std::size_t capacity)
+        {
+            std::vector<slot_t> slots(capacity, slot_t{0, 0});
+            _M_mask = capacity - 1;
+            for (const slot_t &slot : _M_slots)
+            {
+                if (slot.index != 0)
+                {
+                    std::size_t s = slot.hash & _M_mask;
+                    while (slots[s].index != 0)
+                    {
+                        s = (s + 1) & _M_mask;
+                    }
+                    slots[s] = slot;
+                }
+            }
+            _M_slots = std::move(slots);
+        }
+
+        std::vector<value_type> _M_entries; ///< the arena of keys and aggregates
+        std::vector<slot_t> _M_slots;
+        std::size_t _M_mask = 0;
+    };
+
+    template <typename Iterator, typename KeyFn>
+    using hash_key_t = std::decay_t<std::invoke_result_t<KeyFn &, decltype(*std::declval<Iterator &>())>>;
+
+    /// \brief Fold every element x into the aggregate of key_fn(x) with agg(Acc, x), starting from init.
+    template <typename Iterator, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterator first, Iterator last, KeyFn key_fn, Acc init, Agg agg, parallel::sequenced_policy)
+    {
+        hash_groups<hash_key_t<Iterator, KeyFn>, Acc> groups;
+        for (; first != last; ++first)
+        {
+            decltype(auto) x = *first;
+            Acc &acc = groups.find_or_insert(key_fn(x), init);
+            acc = agg(std::move(acc), x);
+        }
+        return groups;
+    }
+
+    template <typename Acc, typename = void>
+    struct is_equality_comparable : std::false_type
+    {
+    };
+
+    template <typename Acc>
+    struct is_equality_comparable<Acc, std::void_t<decltype(bool(std::declval<const Acc &>() == std::declval<const Acc &>()))>>
+        : std::true_type
+    {
+    };
+
+    /// \brief Whether init may seed the aggregates of every chunk, being counted once per chunk that has
+    /// the key: false when merge(init, init) != init, which rules out init as an identity of merge.
+    template <typename Acc, typename Merge>
+    bool seeds_every_chunk(const Acc &init, Merge &merge)
+    {
+        if constexpr (is_equality_comparable<Acc>::value)
+        {
+            return merge(Acc(init), Acc(init)) == init;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    /// \brief Aggregate the chunks of the input on the pool, and fold their aggregates of the same key
+    /// with merge(Acc, Acc); init must be an identity of merge.
+    template <typename Iterator, typename KeyFn, typename Acc, typename Agg, typename Merge>
+    auto groupby_hash(Iterator first, Iterator last, KeyFn key_fn, Acc init, Agg agg, Merge merge, parallel::parallel_policy policy)
+    {
+        using groups_t = hash_groups<hash_key_t<Iterator, KeyFn>, Acc>;
+        parallel::thread_pool &pool = policy.pool();
+        std::size_t n = itertools::split_distance(first, last);
+        std::size_t chunks = std::min(pool.size(), parallel::chunk_count(n, pool.size(), 1 << 14));
+        if (chunks < 2 || !itertools::seeds_every_chunk(init, merge))
+        {
+            return itertools::groupby_hash(first, last, key_fn, std::move(init), agg, parallel::seq);
+        }
+
+        auto views = chunk(range_view<Iterator>(first, last), chunks);
+        std::vector<groups_t> partials(views.size());
+        parallel::parallel_chunks(pool, views.size(), [&](std::size_t c) {
+            partials[c] = itertools::groupby_hash(views[c].begin(), views[c].end(), key_fn, init, agg, parallel::seq);
+        });
+        groups_t groups = std::move(partials[0]);
+        for (std::size_t c = 1; c < partials.size(); ++c)
+        {
+            groups.merge(std::move(partials[c]), merge);
+        }
+        return groups;
+    }
+
+    /// \brief The parallel groupby_hash needs merge(Acc, Acc) as well: agg folds in elements, not aggregates.
+    template <typename Iterator, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterator first, Iterator last, KeyFn key_fn, Acc init, Agg agg, parallel::parallel_policy policy) = delete;
+
+    template <typename Iterator, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterator first, Iterator last, KeyFn key_fn, Acc init, Agg agg)
+    {
+        return itertools::groupby_hash(first, last, key_fn, std::move(init), agg, parallel::seq);
+    }
+
+    template <typename Iterable, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterable &&iterable, KeyFn key_fn, Acc init, Agg agg)
+    {
+        return itertools::groupby_hash(iterable.begin(), iterable.end(), key_fn, std::move(init), agg, parallel::seq);
+    }
+
+    template <typename Iterable, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterable &&iterable, KeyFn key_fn, Acc init, Agg agg, parallel::sequenced_policy policy)
+    {
+        return itertools::groupby_hash(iterable.begin(), iterable.end(), key_fn, std::move(init), agg, policy);
+    }
+
+    /// \brief The parallel groupby_hash needs merge(Acc, Acc) as well: agg folds in elements, not aggregates.
+    template <typename Iterable, typename KeyFn, typename Acc, typename Agg>
+    auto groupby_hash(Iterable &&iterable, KeyFn key_fn, Acc init, Agg agg, parallel::parallel_policy policy) = delete;
+
+    template <typename Iterable, typename KeyFn, typename Acc, typename Agg, typename Merge>
+    auto groupby_hash(Iterable &&iterable, KeyFn key_fn, Acc init, Agg agg, Merge merge, parallel::parallel_policy policy)
+    {
+        return itertools::groupby_hash(iterable.begin(), iterable.end(), key_fn, std::move(init), agg, merge, policy);
+    }
+
+} // namespace itertools
@@ -0,0 +1,107 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file indirect_view.hpp
+ *
+ * A span-like view over a contiguous array of iterators, yielding the elements they point to.
+ */
+
+#pragma once
+
+#include <itertools/iterator_traits.hpp>
+#include <itertools/range_view.hpp>
+
+#include <cstddef>
+#include <iterator>
+
+namespace itertools
+{
+    template <typename Iterator>
+    class indirect_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        indirect_iterator() = default;
+
+        indirect_iterator(const Iterator *p) : _M_p(p) {}
+
+        decltype(auto) operator*() const
+        {
+            return **_M_p;
+        }
+
+        indirect_iterator &operator++()
+        {
+            ++_M_p;
+            return *this;
+        }
+
+        indirect_iterator operator++(int)
+        {
+            indirect_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const indirect_iterator &other) const
+        {
+            return _M_p == other._M_p;
+        }
+
+        bool operator!=(const indirect_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const Iterator *_M_p = nullptr;
+    };
+
+    /// indirect_view does not own the iterators; it is only valid as long as the array is.
+    template <typename Iterator>
+    class indirect_view : public view_base<indirect_view<Iterator>>
+    {
+    public:
+        indirect_view(const Iterator *first, std::size_t size) : _M_first(first), _M_size(size) {}
+
+        indirect_iterator<Iterator> begin() const { return _M_first; }
+
+        indirect_iterator<Iterator> end() const { return _M_first + _M_size; }
+
+        std::size_t size() const { return _M_size; }
+
+        decltype(auto) operator[](std::size_t i) const
+        {
+            return *_M_first[i];
+        }
+
+    private:
+        const Iterator *_M_first;
+        std::size_t _M_size;
+    };
+
+} // namespace itertools
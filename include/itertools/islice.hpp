@@ -27,20 +27,51 @@
  * 
  * step defaults to one. If specified as another value, step determines how many values are
  * skipped between successive calls.
+ *
+ * Unlike Python's islice, negative start, stop and step are allowed, with the meaning they have in
+ * Python's slices, e.g. islice("ABCDEFG", -1, -8, -2) -> G E C A. They need the length of the iterable,
+ * and a negative step needs bidirectional iterators.
+ *
+ * Elements are skipped with split_advance (see splittable.hpp), in constant time for random access input.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace itertools
 {
+    template <typename Iterator, typename = void>
+    struct is_decrementable : std::false_type
+    {
+    };
+
+    template <typename Iterator>
+    struct is_decrementable<Iterator, std::void_t<decltype(--std::declval<Iterator &>())>> : std::true_type
+    {
+    };
+
     template <typename Iterator, typename Index, typename Step>
     class islice_iterator
     {
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        islice_iterator() = default;
+
         islice_iterator(Iterator first, Iterator last, Index idx, Index stop, Step step)
             : _M_it(first), _M_it_last(last), _M_idx(idx), _M_idx_stop(stop), _M_idx_step(step)
         {
@@ -53,20 +84,44 @@ namespace itertools
 
         islice_iterator &operator++()
         {
-            for (Step step = 0; step != _M_idx_step; ++step)
+            move(1);
+            return *this;
+        }
+
+        islice_iterator operator++(int)
+        {
+            islice_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /// \brief Number of elements left in the slice.
+        std::ptrdiff_t remaining() const
+        {
+            if (_M_it == _M_it_last)
             {
-                if (_M_it == _M_it_last)
-                {
-                    break;
-                }
-                if (_M_idx == _M_idx_stop)
-                {
-                    break;
-                }
-                ++_M_it;
-                ++_M_idx;
+                return 0;
             }
-            return *this;
+            std::ptrdiff_t idx = _M_idx, stop = _M_idx_stop, step = _M_idx_step;
+            if (step < 0)
+            {
+                return (idx - stop - step - 1) / -step;
+            }
+            std::ptrdiff_t n = std::min<std::ptrdiff_t>(itertools::split_distance(_M_it, _M_it_last), stop - idx);
+            return (n + step - 1) / step;
+        }
+
+        std::ptrdiff_t split_distance(const islice_iterator &other) const
+        {
+            return remaining() - other.remaining();
+        }
+
+        /// \brief Skip n elements of the slice, that is n * step elements of the input.
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const islice_iterator &last)
+        {
+            n = std::min(n, remaining() - last.remaining());
+            move(n);
+            return n;
         }
 
         bool operator==(const islice_iterator &other) const
@@ -80,24 +135,79 @@ namespace itertools
         }
 
     private:
+        /// \brief Move n elements of the slice ahead, or to the end iterator if that is past the slice.
+        void move(std::ptrdiff_t n)
+        {
+            std::ptrdiff_t idx = _M_idx, stop = _M_idx_stop, step = _M_idx_step;
+            std::ptrdiff_t want = n * step;
+            if (step < 0 ? idx + want <= stop : stop <= idx + want)
+            {
+                // past the slice: become the end iterator
+                _M_it = _M_it_last;
+            }
+            else if (step < 0)
+            {
+                if constexpr (is_subtractable<Iterator>::value)
+                {
+                    _M_it += want;
+                }
+                else if constexpr (is_decrementable<Iterator>::value)
+                {
+                    for (std::ptrdiff_t k = want; k != 0; ++k)
+                    {
+                        --_M_it;
+                    }
+                }
+                _M_idx = static_cast<Index>(idx + want);
+            }
+            else
+            {
+                _M_idx = static_cast<Index>(idx + itertools::split_advance(_M_it, want, _M_it_last));
+            }
+        }
+
         Iterator _M_it;
         Iterator _M_it_last;
-        Index _M_idx;
-        Index _M_idx_stop;
-        Step _M_idx_step;
+        Index _M_idx{};
+        Index _M_idx_stop{};
+        Step _M_idx_step{};
     };
 
+    template <typename T>
+    constexpr bool is_negative(T x)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            return x < 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /// \brief Index i of a slice of n elements, as Python does: negative i counts from the end, and the
+    /// result is clamped to [lo, hi].
+    inline std::ptrdiff_t slice_index(std::ptrdiff_t i, std::ptrdiff_t n, std::ptrdiff_t lo, std::ptrdiff_t hi)
+    {
+        return std::clamp(i < 0 ? i + n : i, lo, hi);
+    }
+
     template <typename Iterator, typename Index, typename Step>
     auto islice(Iterator first, Iterator last, Index start, Index stop, Step step)
     {
         using it_t = islice_iterator<Iterator, Index, Step>;
         it_t it_last(last, last, start, stop, step);
-        if (0 < step)
+        if (step == 0)
         {
+            throw std::runtime_error("islice() step is zero");
+        }
+        if (0 < step && !is_negative(start) && !is_negative(stop))
+        {
+            // no need for the length, so that the iterable may be endless
             if (start < stop)
             {
-                for (Index i = 0; i < start && first != last; ++i, ++first)
-                    ;
+                itertools::split_advance(first, start, last);
                 return range_view<it_t>(it_t(first, last, start, stop, step), it_last);
             }
             else
@@ -106,17 +216,33 @@ namespace itertools
                 return range_view<it_t>(it_last, it_last);
             }
         }
-        else
+
+        std::ptrdiff_t n = itertools::split_distance(first, last);
+        std::ptrdiff_t lo = 0, hi = n;
+        if (is_negative(step))
+        {
+            if constexpr (!is_decrementable<Iterator>::value)
+            {
+                throw std::runtime_error("islice() step is negative, but the iterable is not bidirectional");
+            }
+            lo = -1;
+            hi = n - 1;
+        }
+        std::ptrdiff_t i = slice_index(start, n, lo, hi);
+        std::ptrdiff_t j = slice_index(stop, n, lo, hi);
+        if (is_negative(step) ? i <= j : j <= i)
         {
-            // negative step not supported yet
-            throw std::runtime_error("islice() step is non-positive");
+            // empty range
+            return range_view<it_t>(it_last, it_last);
         }
+        itertools::split_advance(first, i, last);
+        return range_view<it_t>(it_t(first, last, static_cast<Index>(i), static_cast<Index>(j), step), it_last);
     }
 
     template <typename Iterable, typename Index, typename Step>
     auto islice(Iterable &&iterable, Index start, Index stop, Step step)
     {
-        return islice(iterable.begin(), iterable.end(), start, stop, step);
+        return islice(common_begin(iterable), common_end(iterable), start, stop, step);
     }
 
 } // namespace itertools
@@ -0,0 +1,190 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file iterator_traits.hpp
+ *
+ * Helpers for the member types of the iterators of the adaptors, so that they work with std::iterator_traits,
+ * the algorithms of the standard library, and, in C++20, the concepts of <iterator> and <ranges>.
+ *
+ * - forward_iterator_category_t: the weakest category of the wrapped iterators, but at most forward;
+ * - view_iterator_category_t: random access if all the wrapped iterators are, and at most forward otherwise;
+ * - value_type_of_t: the value type for a reference type, element-wise for tuples of references;
+ * - copyable_box: holds a function object, e.g. a lambda, so that iterators holding it can be default
+ *   constructed and assigned.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace itertools
+{
+    template <typename Iterator, typename = void>
+    struct iterator_category_of
+    {
+        using type = std::input_iterator_tag;
+    };
+
+    template <typename Iterator>
+    struct iterator_category_of<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category>>
+    {
+        using type = typename std::iterator_traits<Iterator>::iterator_category;
+    };
+
+    /// \brief The weakest category of the iterators; input for iterators that do not declare one.
+    template <typename... Iterators>
+    using common_iterator_category_t = std::common_type_t<typename iterator_category_of<Iterators>::type...>;
+
+    template <typename... Iterators>
+    constexpr bool all_random_access()
+    {
+        return std::is_base_of_v<std::random_access_iterator_tag, common_iterator_category_t<Iterators...>>;
+    }
+
+    /// \brief The weakest category of the iterators, but at most forward, for adaptors that cannot move back.
+    template <typename... Iterators>
+    using forward_iterator_category_t = std::common_type_t<common_iterator_category_t<Iterators...>, std::forward_iterator_tag>;
+
+    /// \brief Random access if all the iterators are, for adaptors that can jump; otherwise at most forward.
+    template <typename... Iterators>
+    using view_iterator_category_t = std::conditional_t<all_random_access<Iterators...>(),
+                                                        std::random_access_iterator_tag,
+                                                        forward_iterator_category_t<Iterators...>>;
+
+    template <std::size_t, typename T>
+    using always_t = T;
+
+    template <typename T, typename Indices>
+    struct tuple_of_n;
+
+    template <typename T, std::size_t... I>
+    struct tuple_of_n<T, std::index_sequence<I...>>
+    {
+        using type = std::tuple<always_t<I, T>...>;
+    };
+
+    /// \brief std::tuple of N times T, as yielded by the combinatoric iterators.
+    template <typename T, std::size_t N>
+    using tuple_of_n_t = typename tuple_of_n<T, std::make_index_sequence<N>>::type;
+
+    template <typename Reference>
+    struct value_type_of
+    {
+        using type = std::remove_cv_t<std::remove_reference_t<Reference>>;
+    };
+
+    template <typename... Refs>
+    struct value_type_of<std::tuple<Refs...>>
+    {
+        using type = std::tuple<std::remove_cv_t<std::remove_reference_t<Refs>>...>;
+    };
+
+    template <typename Reference>
+    using value_type_of_t = typename value_type_of<std::remove_cv_t<std::remove_reference_t<Reference>>>::type;
+
+    /// copyable_box holds a function object, and can be default constructed and assigned even if the
+    /// function object cannot, like a lambda: it is then destroyed and copy constructed again.
+    /// A default constructed box is empty, unless the function object can be default constructed.
+    template <typename Fn>
+    class copyable_box
+    {
+    public:
+        copyable_box()
+        {
+            if constexpr (std::is_default_constructible_v<Fn>)
+            {
+                _M_fn.emplace();
+            }
+        }
+
+        copyable_box(const Fn &fn) : _M_fn(fn) {}
+
+        copyable_box(const copyable_box &) = default;
+
+        copyable_box(copyable_box &&) = default;
+
+        copyable_box &operator=(const copyable_box &other)
+        {
+            if (this != &other)
+            {
+                if constexpr (std::is_copy_assignable_v<Fn>)
+                {
+                    _M_fn = other._M_fn;
+                }
+                else if (other._M_fn)
+                {
+                    _M_fn.emplace(*other._M_fn);
+                }
+                else
+                {
+                    _M_fn.reset();
+                }
+            }
+            return *this;
+        }
+
+        copyable_box &operator=(copyable_box &&other)
+        {
+            if (this != &other)
+            {
+                if constexpr (std::is_move_assignable_v<Fn>)
+                {
+                    _M_fn = std::move(other._M_fn);
+                }
+                else if (other._M_fn)
+                {
+                    _M_fn.emplace(std::move(*other._M_fn));
+                }
+                else
+                {
+                    _M_fn.reset();
+                }
+            }
+            return *this;
+        }
+
+        Fn &operator*() { return *_M_fn; }
+
+        const Fn &operator*() const { return *_M_fn; }
+
+        template <typename... Args>
+        decltype(auto) operator()(Args &&... args)
+        {
+            return (*_M_fn)(std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        decltype(auto) operator()(Args &&... args) const
+        {
+            return (*_M_fn)(std::forward<Args>(args)...);
+        }
+
+    private:
+        std::optional<Fn> _M_fn;
+    };
+
+} // namespace itertools
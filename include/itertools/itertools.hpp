@@ -23,6 +23,8 @@
  */
 
 #include <itertools/accumulate.hpp>
+#include <itertools/bitmask.hpp>
+#include <itertools/cache.hpp>
 #include <itertools/chain.hpp>
 #include <itertools/combinations.hpp>
 #include <itertools/combinations_with_replacement.hpp>
@@ -33,11 +35,18 @@
 #include <itertools/filter.hpp>
 #include <itertools/filterfalse.hpp>
 #include <itertools/groupby.hpp>
+#include <itertools/groupby_hash.hpp>
+#include <itertools/indirect_view.hpp>
 #include <itertools/islice.hpp>
+#include <itertools/iterator_traits.hpp>
+#include <itertools/parallel.hpp>
 #include <itertools/permutations.hpp>
 #include <itertools/product.hpp>
 #include <itertools/range_view.hpp>
 #include <itertools/repeat.hpp>
+#include <itertools/segmented.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 #include <itertools/starmap.hpp>
 #include <itertools/takewhile.hpp>
 #include <itertools/tee.hpp>
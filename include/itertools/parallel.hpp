@@ -0,0 +1,401 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file parallel.hpp
+ *
+ * Run for_each, reduce and find_first over a view on a work-stealing thread pool.
+ *
+ * The view is cut into chunks with the splittable protocol (see splittable.hpp): in constant time for
+ * product, combinations, combinations_with_replacement and random access input, and by walking the
+ * view once for the other adaptors.
+ */
+
+#pragma once
+
+#include <itertools/segmented.hpp>
+#include <itertools/splittable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace itertools
+{
+    namespace parallel
+    {
+        /// thread_pool runs tasks on std::threads, each with its own deque of tasks.
+        ///
+        /// A worker pushes and pops tasks at the back of its own deque, and when that is empty,
+        /// steals from the front of the others', where the oldest (and, for split ranges, largest) tasks are.
+        class thread_pool
+        {
+        public:
+            explicit thread_pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+            {
+                for (std::size_t i = 0; i != threads; ++i)
+                {
+                    _M_queues.push_back(std::make_unique<worker_queue>());
+                }
+                for (std::size_t i = 0; i != threads; ++i)
+                {
+                    _M_threads.emplace_back([this, i] { run(i); });
+                }
+            }
+
+            thread_pool(const thread_pool &) = delete;
+
+            thread_pool &operator=(const thread_pool &) = delete;
+
+            ~thread_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_M_mutex);
+                    _M_stop = true;
+                }
+                _M_cv.notify_all();
+                for (auto &thread : _M_threads)
+                {
+                    thread.join();
+                }
+            }
+
+            std::size_t size() const
+            {
+                return _M_threads.size();
+            }
+
+            /// \brief Queue a task; from a worker of this pool, onto its own deque.
+            void submit(std::function<void()> task)
+            {
+                std::size_t i = (_S_pool == this) ? _S_index : _M_next++ % _M_queues.size();
+                {
+                    // counted before the queue is unlocked, so that pop() never takes a task not yet counted
+                    std::lock_guard<std::mutex> lock(_M_queues[i]->mutex);
+                    _M_queues[i]->tasks.push_back(std::move(task));
+                    std::lock_guard<std::mutex> pending_lock(_M_mutex);
+                    ++_M_pending;
+                }
+                _M_cv.notify_one();
+            }
+
+            /// \brief Run one queued task, if any, on the calling thread.
+            bool run_one()
+            {
+                std::function<void()> task;
+                std::size_t self = (_S_pool == this) ? _S_index : 0;
+                if (!pop(self, task))
+                {
+                    return false;
+                }
+                task();
+                return true;
+            }
+
+            /// \brief A pool with one thread per hardware thread.
+            static thread_pool &global()
+            {
+                static thread_pool pool;
+                return pool;
+            }
+
+        private:
+            struct worker_queue
+            {
+                std::mutex mutex;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            bool pop(std::size_t self, std::function<void()> &task)
+            {
+                std::size_t n = _M_queues.size();
+                for (std::size_t k = 0; k != n; ++k)
+                {
+                    worker_queue &queue = *_M_queues[(self + k) % n];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.tasks.empty())
+                    {
+                        continue;
+                    }
+                    if (k == 0)
+                    {
+                        task = std::move(queue.tasks.back());
+                        queue.tasks.pop_back();
+                    }
+                    else
+                    {
+                        task = std::move(queue.tasks.front());
+                        queue.tasks.pop_front();
+                    }
+                    std::lock_guard<std::mutex> pending_lock(_M_mutex);
+                    --_M_pending;
+                    return true;
+                }
+                return false;
+            }
+
+            void run(std::size_t self)
+            {
+                _S_pool = this;
+                _S_index = self;
+                std::function<void()> task;
+                for (;;)
+                {
+                    if (pop(self, task))
+                    {
+                        task();
+                        task = nullptr;
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(_M_mutex);
+                    _M_cv.wait(lock, [this] { return _M_stop || _M_pending != 0; });
+                    if (_M_stop)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            std::vector<std::unique_ptr<worker_queue>> _M_queues;
+            std::vector<std::thread> _M_threads;
+            std::mutex _M_mutex;
+            std::condition_variable _M_cv;
+            std::size_t _M_pending = 0;
+            bool _M_stop = false;
+            std::atomic<std::size_t> _M_next{0};
+
+            static inline thread_local thread_pool *_S_pool = nullptr;
+            static inline thread_local std::size_t _S_index = 0;
+        };
+
+        /// \brief Call body(chunk) for every chunk in [0, chunks) on the pool, and wait for all of them.
+        ///
+        /// The range of chunks is halved recursively: one half is queued, where an idle worker may steal it,
+        /// and the other is processed right away. The calling thread runs queued tasks until there are none
+        /// left, then sleeps until the chunks taken by other threads are done.
+        /// The first exception thrown by body is rethrown here.
+        template <typename Body>
+        void parallel_chunks(thread_pool &pool, std::size_t chunks, Body body)
+        {
+            struct job_t
+            {
+                std::atomic<std::size_t> outstanding{0};
+                std::mutex mutex;
+                std::condition_variable done;
+                std::exception_ptr error;
+            } job;
+
+            std::function<void(std::size_t, std::size_t)> split = [&](std::size_t lo, std::size_t hi) {
+                try
+                {
+                    while (hi - lo > 1)
+                    {
+                        std::size_t mid = lo + (hi - lo) / 2;
+                        ++job.outstanding;
+                        pool.submit([&split, mid, hi] { split(mid, hi); });
+                        hi = mid;
+                    }
+                    body(lo);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(job.mutex);
+                    if (!job.error)
+                    {
+                        job.error = std::current_exception();
+                    }
+                }
+                // under the lock, so that the caller cannot return and destroy the job before the notification
+                std::lock_guard<std::mutex> lock(job.mutex);
+                if (--job.outstanding == 0)
+                {
+                    job.done.notify_all();
+                }
+            };
+
+            if (chunks == 0)
+            {
+                return;
+            }
+            ++job.outstanding;
+            split(0, chunks);
+            while (job.outstanding != 0 && pool.run_one())
+                ;
+            {
+                std::unique_lock<std::mutex> lock(job.mutex);
+                job.done.wait(lock, [&job] { return job.outstanding == 0; });
+            }
+            if (job.error)
+            {
+                std::rethrow_exception(job.error);
+            }
+        }
+
+        /// \brief Number of chunks to cut n elements into: about 16 per worker, so that stealing can even out
+        /// uneven work, but never smaller than min_chunk elements.
+        inline std::size_t chunk_count(std::size_t n, std::size_t workers, std::size_t min_chunk = 64)
+        {
+            std::size_t chunks = std::min(workers * 16, (n + min_chunk - 1) / min_chunk);
+            return std::max<std::size_t>(chunks, n == 0 ? 0 : 1);
+        }
+
+        /// \brief Policy of the eager algorithms that can also run on the calling thread alone.
+        struct sequenced_policy
+        {
+        };
+
+        struct parallel_policy
+        {
+            /// \brief Run on the given pool rather than the global one.
+            parallel_policy on(thread_pool &p) const { return parallel_policy{&p}; }
+
+            thread_pool &pool() const { return _M_pool ? *_M_pool : thread_pool::global(); }
+
+            thread_pool *_M_pool = nullptr;
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+
+        /// \brief Call fn on every element of the view, in no particular order.
+        template <typename View, typename Fn>
+        void for_each(thread_pool &pool, View &&view, Fn fn)
+        {
+            std::size_t n = split_distance(view.begin(), view.end());
+            auto chunks = chunk(view, chunk_count(n, pool.size()));
+            parallel_chunks(pool, chunks.size(), [&](std::size_t c) {
+                itertools::for_each_segment(chunks[c], [&fn](auto first, auto last) {
+                    for (; first != last; ++first)
+                    {
+                        fn(*first);
+                    }
+                });
+            });
+        }
+
+        template <typename View, typename Fn>
+        void for_each(View &&view, Fn fn)
+        {
+            for_each(thread_pool::global(), view, fn);
+        }
+
+        /// \brief Fold transform(element) for every element of the view into init with op.
+        ///
+        /// op must be associative; chunks are folded separately and their results are combined in order.
+        template <typename View, typename T, typename Op, typename Transform>
+        T transform_reduce(thread_pool &pool, View &&view, T init, Op op, Transform transform)
+        {
+            std::size_t n = split_distance(view.begin(), view.end());
+            auto chunks = chunk(view, chunk_count(n, pool.size()));
+            std::vector<std::unique_ptr<T>> partials(chunks.size());
+            parallel_chunks(pool, chunks.size(), [&](std::size_t c) {
+                auto it = chunks[c].begin();
+                auto last = chunks[c].end();
+                if (it == last)
+                {
+                    return;
+                }
+                T acc = transform(*it);
+                for (++it; it != last; ++it)
+                {
+                    acc = op(std::move(acc), transform(*it));
+                }
+                partials[c] = std::make_unique<T>(std::move(acc));
+            });
+            for (auto &partial : partials)
+            {
+                if (partial)
+                {
+                    init = op(std::move(init), std::move(*partial));
+                }
+            }
+            return init;
+        }
+
+        template <typename View, typename T, typename Op, typename Transform>
+        T transform_reduce(View &&view, T init, Op op, Transform transform)
+        {
+            return transform_reduce(thread_pool::global(), view, std::move(init), op, transform);
+        }
+
+        /// \brief Fold every element of the view into init with op, which must be associative.
+        template <typename View, typename T, typename Op>
+        T reduce(thread_pool &pool, View &&view, T init, Op op)
+        {
+            return transform_reduce(pool, view, std::move(init), op, [](auto &&x) -> T { return x; });
+        }
+
+        template <typename View, typename T, typename Op>
+        T reduce(View &&view, T init, Op op)
+        {
+            return reduce(thread_pool::global(), view, std::move(init), op);
+        }
+
+        /// \brief Iterator to the first element (in the order of the view) for which pred is true, or end().
+        ///
+        /// Chunks past the first chunk with a match found so far are skipped.
+        template <typename View, typename Pred>
+        auto find_first(thread_pool &pool, View &&view, Pred pred)
+        {
+            std::size_t n = split_distance(view.begin(), view.end());
+            auto chunks = chunk(view, chunk_count(n, pool.size()));
+            std::vector<decltype(view.begin())> hits;
+            hits.reserve(chunks.size());
+            for (auto &c : chunks)
+            {
+                hits.push_back(c.end());
+            }
+            std::atomic<std::size_t> found{chunks.size()};
+            parallel_chunks(pool, chunks.size(), [&](std::size_t c) {
+                auto last = chunks[c].end();
+                for (auto it = chunks[c].begin(); it != last && c < found; ++it)
+                {
+                    if (pred(*it))
+                    {
+                        hits[c] = it;
+                        std::size_t best = found;
+                        while (c < best && !found.compare_exchange_weak(best, c))
+                            ;
+                        return;
+                    }
+                }
+            });
+            return found == chunks.size() ? view.end() : hits[found];
+        }
+
+        template <typename View, typename Pred>
+        auto find_first(View &&view, Pred pred)
+        {
+            return find_first(thread_pool::global(), view, pred);
+        }
+
+    } // namespace parallel
+
+} // namespace itertools
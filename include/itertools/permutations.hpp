@@ -35,37 +35,101 @@
 
 #pragma once
 
-#include <functional>
+#include <itertools/indirect_view.hpp>
+#include <itertools/iterator_traits.hpp>
+#include <itertools/range_view.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace itertools
 {
-    template <typename... Iterators>
-    class permutations_iterator;
+    /// \brief Advance pool[0, r) to the next r-permutation of the pool, in lexicographic order by position.
+    ///
+    /// The same algorithm as Python's: cycles[i] counts how many more candidates position i will take
+    /// before it is rotated back to its original order. Each call does one swap, plus a rotation of
+    /// pool[i, n) whenever position i wraps, which is rare enough to be amortized O(1) per call.
+    ///
+    /// \return false once all r-permutations have been generated.
+    template <typename Pool, typename Cycles>
+    bool next_partial_permutation(Pool &pool, Cycles &cycles, std::size_t r)
+    {
+        std::size_t n = pool.size();
+        for (std::size_t i = r; i-- > 0;)
+        {
+            if (--cycles[i] == 0)
+            {
+                std::rotate(pool.begin() + i, pool.begin() + i + 1, pool.end());
+                cycles[i] = n - i;
+            }
+            else
+            {
+                std::swap(pool[i], pool[n - cycles[i]]);
+                return true;
+            }
+        }
+        return false;
+    }
 
-    template <typename Iterator>
-    class permutations_iterator<Iterator>
+    /// permutations_iterator keeps all the input iterators in a pool, the first N of which
+    /// make up the current permutation.
+    template <std::size_t N, typename Iterator>
+    class permutations_iterator
     {
     public:
-        permutations_iterator(Iterator it, Iterator last) : _M_it(it), _M_it_last(last) {}
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = tuple_of_n_t<decltype(*std::declval<const Iterator &>()), N>;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        /// \brief The end iterator.
+        permutations_iterator() : _M_cycles{}, _M_done(true) {}
+
+        permutations_iterator(Iterator first, Iterator last) : _M_cycles{}, _M_done(false)
+        {
+            for (; first != last; ++first)
+            {
+                _M_pool.push_back(first);
+            }
+            if (_M_pool.size() < N)
+            {
+                _M_done = true;
+                return;
+            }
+            for (std::size_t i = 0; i != N; ++i)
+            {
+                _M_cycles[i] = _M_pool.size() - i;
+            }
+        }
 
         decltype(auto) operator*() const
         {
-            return std::make_tuple(*_M_it);
+            return deref_impl(std::make_index_sequence<N>());
         }
 
-        permutations_iterator<Iterator> &operator++()
+        permutations_iterator &operator++()
         {
-            ++_M_it;
+            _M_done = !next_partial_permutation(_M_pool, _M_cycles, N);
             return *this;
         }
 
-        bool repeated(const Iterator &it) const { return _M_it == it; }
+        permutations_iterator operator++(int)
+        {
+            permutations_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
 
         bool operator==(const permutations_iterator &other) const
         {
-            return _M_it == other._M_it;
+            // cycles encode the position in the sequence, like the digits of a factorial number
+            return _M_done == other._M_done && (_M_done || _M_cycles == other._M_cycles);
         }
 
         bool operator!=(const permutations_iterator &other) const
@@ -73,142 +137,146 @@ namespace itertools
             return !(*this == other);
         }
 
-    protected:
-        Iterator _M_it;
-        Iterator _M_it_last;
+    private:
+        template <std::size_t... I>
+        decltype(auto) deref_impl(std::index_sequence<I...>) const
+        {
+            return std::tuple<decltype(*_M_pool[I])...>(*_M_pool[I]...);
+        }
+
+        std::vector<Iterator> _M_pool;
+        std::array<std::size_t, N> _M_cycles;
+        bool _M_done;
     };
 
-    template <typename Iterator, typename... Iterators>
-    class permutations_iterator<Iterator, Iterators...>
+    template <std::size_t N, typename Iterator>
+    auto permutations(Iterator first, Iterator last)
+    {
+        static_assert(N > 0);
+        using perm_it_t = permutations_iterator<N, Iterator>;
+        return range_view(perm_it_t(first, last), perm_it_t());
+    }
+
+    template <std::size_t N, typename Iterable>
+    auto permutations(Iterable &&iterable)
+    {
+        return permutations<N>(iterable.begin(), iterable.end());
+    }
+
+    /// Same as permutations_iterator, with r known only at runtime.
+    ///
+    /// The pool and the cycles are allocated once on construction; operator++ never allocates.
+    template <typename Iterator>
+    class dynamic_permutations_iterator
     {
     public:
-        permutations_iterator(Iterator it, Iterator it_last, permutations_iterator<Iterators...> its,
-                              permutations_iterator<Iterators...> its_first, permutations_iterator<Iterators...> its_last)
-            : _M_it(it), _M_it_last(it_last), _M_its(its), _M_its_first(its_first), _M_its_last(its_last) {}
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = indirect_view<Iterator>;
+        using value_type = indirect_view<Iterator>;
+        using pointer = void;
 
-        decltype(auto) operator*() const
-        {
-            return std::tuple_cat(std::make_tuple(*_M_it), *_M_its);
-        }
+        /// \brief The end iterator.
+        dynamic_permutations_iterator() : _M_r(0), _M_done(true) {}
 
-        permutations_iterator &operator++()
+        dynamic_permutations_iterator(Iterator first, Iterator last, std::size_t r)
+            : _M_r(r), _M_done(false)
         {
-            do
+            for (; first != last; ++first)
             {
-                if (++_M_its == _M_its_last)
-                {
-                    if (++_M_it == _M_it_last)
-                    {
-                        break;
-                    }
-                    _M_its = _M_its_first;
-                }
-            } while (_M_its.repeated(_M_it));
-
-            return *this;
+                _M_pool.push_back(first);
+            }
+            if (_M_pool.size() < r)
+            {
+                _M_done = true;
+                return;
+            }
+            _M_cycles.reserve(r);
+            for (std::size_t i = 0; i != r; ++i)
+            {
+                _M_cycles.push_back(_M_pool.size() - i);
+            }
         }
 
-        bool repeated(const Iterator &it) const { return _M_it == it || _M_its.repeated(it); }
-
-        bool operator==(const permutations_iterator &other) const
+        indirect_view<Iterator> operator*() const
         {
-            return _M_it == other._M_it && _M_its == other._M_its;
+            return indirect_view<Iterator>(_M_pool.data(), _M_r);
         }
 
-        bool operator!=(const permutations_iterator &other) const
+        dynamic_permutations_iterator &operator++()
         {
-            return !(*this == other);
+            _M_done = !next_partial_permutation(_M_pool, _M_cycles, _M_r);
+            return *this;
         }
 
-    protected:
-        Iterator _M_it;
-        Iterator _M_it_last;
-        permutations_iterator<Iterators...> _M_its;
-        permutations_iterator<Iterators...> _M_its_first;
-        permutations_iterator<Iterators...> _M_its_last;
-    };
-
-    template <typename... Iterables>
-    class permutations_impl;
-
-    template <typename Iterator>
-    class permutations_impl<Iterator>
-    {
-    public:
-        permutations_impl(Iterator first, Iterator last) : _M_it_first(first), _M_it_last(last) {}
+        dynamic_permutations_iterator operator++(int)
+        {
+            dynamic_permutations_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
 
-        auto begin() const
+        bool operator==(const dynamic_permutations_iterator &other) const
         {
-            return permutations_iterator<Iterator>(_M_it_first, _M_it_last);
+            return _M_done == other._M_done && (_M_done || _M_cycles == other._M_cycles);
         }
 
-        auto end() const
+        bool operator!=(const dynamic_permutations_iterator &other) const
         {
-            return permutations_iterator<Iterator>(_M_it_last, _M_it_last);
+            return !(*this == other);
         }
 
-    protected:
-        Iterator _M_it_first;
-        Iterator _M_it_last;
+    private:
+        std::vector<Iterator> _M_pool;
+        std::vector<std::size_t> _M_cycles;
+        std::size_t _M_r;
+        bool _M_done;
     };
 
-    template <typename Iterator, typename... Iterators>
-    class permutations_impl<Iterator, Iterators...>
+    template <typename Iterator>
+    class dynamic_permutations_impl : public view_base<dynamic_permutations_impl<Iterator>>
     {
     public:
-        template <typename... ArgsT>
-        permutations_impl(Iterator first, Iterator last, ArgsT... rest)
-            : _M_it_first(first), _M_it_last(last), _M_sub_product(rest...) {}
+        dynamic_permutations_impl(Iterator first, Iterator last, std::size_t r)
+            : _M_it_first(first), _M_it_last(last), _M_r(r) {}
 
         auto begin() const
         {
-            return permutations_iterator<Iterator, Iterators...>(_M_it_first, _M_it_last, _M_sub_product.begin(), _M_sub_product.begin(), _M_sub_product.end());
+            return dynamic_permutations_iterator<Iterator>(_M_it_first, _M_it_last, _M_r);
         }
 
         auto end() const
         {
-            return permutations_iterator<Iterator, Iterators...>(_M_it_last, _M_it_last, _M_sub_product.end(), _M_sub_product.begin(), _M_sub_product.end());
+            return dynamic_permutations_iterator<Iterator>();
         }
 
-    protected:
+    private:
         Iterator _M_it_first;
         Iterator _M_it_last;
-        permutations_impl<Iterators...> _M_sub_product;
+        std::size_t _M_r;
     };
 
-    template <typename... Iterables>
-    decltype(auto) __permutations(Iterables &&... iterables)
+    /// \brief Permutations of r elements, r being a runtime value.
+    ///
+    /// Each permutation is an indirect_view of the selected elements.
+    /// It refers to the state of the iterator, and is invalidated when the iterator advances.
+    template <typename Iterator>
+    auto permutations(Iterator first, Iterator last, std::size_t r)
     {
-        return std::apply(
-            [&iterables...](auto &&... args) {
-                return permutations_impl<decltype(iterables.begin())...>(std::forward<decltype(args)>(args)...);
-            },
-            std::tuple_cat(std::make_tuple(iterables.begin(), iterables.end())...));
+        return dynamic_permutations_impl<Iterator>(first, last, r);
     }
 
-    template <std::size_t N, typename T>
-    decltype(auto) clone_args(T &&arg)
+    template <typename Iterable>
+    auto permutations(Iterable &&iterable, std::size_t r)
     {
-        if constexpr (N == 0)
-        {
-            return std::tuple<>();
-        }
-        else
-        {
-            return std::tuple_cat(std::tuple<T &&>(std::forward<T>(arg)), clone_args<N - 1>(std::forward<T>(arg)));
-        }
+        return permutations(iterable.begin(), iterable.end(), r);
     }
 
-    template <std::size_t N, typename Iterable>
+    /// \brief Full-length permutations.
+    template <typename Iterable>
     auto permutations(Iterable &&iterable)
     {
-        // call __permutations(iterable, iterable, ...); // N * iterables
-        static_assert(N > 0);
-        return std::apply(
-            [](auto &&... args) {
-                return __permutations(std::forward<decltype(args)>(args)...);
-            },
-            clone_args<N>(std::forward<Iterable>(iterable)));
+        return permutations(iterable, std::distance(iterable.begin(), iterable.end()));
     }
 
 } // namespace itertools
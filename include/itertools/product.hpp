@@ -22,79 +22,150 @@
  * @file product.hpp
  *
  * Cartesian product of input iterables. Equivalent to nested for-loops.
+ *
+ * The tuples hold references into the iterables rather than copies of the elements.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
+#include <itertools/range_view.hpp>
+
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace itertools
 {
-    // product_iterator is a tuple of regular iterators
+    // product_iterator keeps, for each dimension, the current iterator and the [first, last)
+    // range it cycles through, in flat tuples; its size grows linearly with the number of dimensions.
+    //
+    // It advances like an odometer: the last dimension moves fastest.
+    // At the end, the first dimension is at its last and all the others are at their first.
+    //
+    // When every iterator is random access, so is the product_iterator:
+    // positions are mixed-radix numbers whose radices are the sizes of the dimensions.
     template <typename... Iterators>
-    class product_iterator;
-
-    // product_iterator specialization for just one iterator
-    template <typename Iterator>
-    class product_iterator<Iterator>
+    class product_iterator
     {
+        using iterators_t = std::tuple<Iterators...>;
+
+        static constexpr std::size_t N = sizeof...(Iterators);
+
+        static constexpr bool random_access = all_random_access<Iterators...>();
+
     public:
-        product_iterator(Iterator it, Iterator last) : _M_it(it), _M_it_last(last) {}
+        using iterator_category = view_iterator_category_t<Iterators...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::tuple<decltype(*std::declval<const Iterators &>())...>;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        product_iterator() = default;
+
+        product_iterator(iterators_t its, iterators_t firsts, iterators_t lasts)
+            : _M_its(its), _M_firsts(firsts), _M_lasts(lasts) {}
+
+        /// \brief Number of tuples before this position.
+        difference_type index() const
+        {
+            return index_impl(std::make_index_sequence<N>());
+        }
+
+        /// \brief Move to the position that has n tuples before it.
+        void seek(difference_type n)
+        {
+            // an empty product only has its end, and an empty dimension is no radix to divide by
+            if (empty_impl(std::make_index_sequence<N>()))
+            {
+                _M_its = _M_firsts;
+                std::get<0>(_M_its) = std::get<0>(_M_lasts);
+                return;
+            }
+            seek_impl(n, std::make_index_sequence<N>());
+        }
 
         decltype(auto) operator*() const
         {
-            return std::make_tuple(*_M_it);
+            return deref_impl(std::make_index_sequence<N>());
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        decltype(auto) operator[](difference_type n) const
+        {
+            return *(*this + n);
         }
 
-        product_iterator<Iterator> &operator++()
+        product_iterator &operator++()
         {
-            ++_M_it;
+            increment<N - 1>();
             return *this;
         }
 
-        bool operator==(const product_iterator &other) const
+        product_iterator operator++(int)
         {
-            return _M_it == other._M_it;
+            product_iterator tmp = *this;
+            ++*this;
+            return tmp;
         }
 
-        bool operator!=(const product_iterator &other) const
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator &operator--()
         {
-            return !(*this == other);
+            return *this -= 1;
         }
 
-    private:
-        Iterator _M_it;
-        Iterator _M_it_last;
-    };
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator operator--(int)
+        {
+            product_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
 
-    // product_iterator general case
-    template <typename Iterator, typename... Iterators>
-    class product_iterator<Iterator, Iterators...>
-    {
-    public:
-        product_iterator(Iterator it, Iterator it_last, product_iterator<Iterators...> its,
-                         product_iterator<Iterators...> its_first, product_iterator<Iterators...> its_last)
-            : _M_it(it), _M_it_last(it_last), _M_its(its), _M_its_first(its_first), _M_its_last(its_last) {}
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator &operator+=(difference_type n)
+        {
+            seek(index() + n);
+            return *this;
+        }
 
-        decltype(auto) operator*() const
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator &operator-=(difference_type n)
         {
-            return std::tuple_cat(std::make_tuple(*_M_it), *_M_its);
+            return *this += -n;
         }
 
-        product_iterator &operator++()
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator operator+(difference_type n) const
         {
-            if (++_M_its == _M_its_last && ++_M_it != _M_it_last)
-            {
-                _M_its = _M_its_first;
-            }
-            return *this;
+            return product_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend product_iterator operator+(difference_type n, const product_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        product_iterator operator-(difference_type n) const
+        {
+            return product_iterator(*this) -= n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const product_iterator &other) const
+        {
+            return index() - other.index();
         }
 
         bool operator==(const product_iterator &other) const
         {
-            return _M_it == other._M_it && _M_its == other._M_its;
+            return _M_its == other._M_its;
         }
 
         bool operator!=(const product_iterator &other) const
@@ -102,74 +173,147 @@ namespace itertools
             return !(*this == other);
         }
 
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const product_iterator &other) const
+        {
+            return _M_its < other._M_its;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const product_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const product_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const product_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
     private:
-        Iterator _M_it;
-        Iterator _M_it_last;
-        product_iterator<Iterators...> _M_its;
-        product_iterator<Iterators...> _M_its_first;
-        product_iterator<Iterators...> _M_its_last;
-    };
+        template <std::size_t I>
+        void increment()
+        {
+            auto &it = std::get<I>(_M_its);
+            if constexpr (I == 0)
+            {
+                ++it;
+            }
+            else if (++it == std::get<I>(_M_lasts))
+            {
+                it = std::get<I>(_M_firsts);
+                increment<I - 1>();
+            }
+        }
 
-    // similar strategy for product_impl
-    template <typename... Iterators>
-    class product_impl;
+        template <std::size_t... I>
+        decltype(auto) deref_impl(std::index_sequence<I...>) const
+        {
+            return std::tuple<decltype(*std::get<I>(_M_its))...>(*std::get<I>(_M_its)...);
+        }
 
-    // product_impl specialization for just one iterator
-    template <typename Iterator>
-    class product_impl<Iterator>
-    {
-    public:
-        product_impl(Iterator first, Iterator last) : _M_it_first(first), _M_it_last(last) {}
+        template <std::size_t... I>
+        bool empty_impl(std::index_sequence<I...>) const
+        {
+            return ((std::get<I>(_M_firsts) == std::get<I>(_M_lasts)) || ...);
+        }
 
-        auto begin() const
+        template <std::size_t... I>
+        difference_type index_impl(std::index_sequence<I...>) const
         {
-            return product_iterator<Iterator>(_M_it_first, _M_it_last);
+            difference_type n = 0;
+            ((n = n * (std::get<I>(_M_lasts) - std::get<I>(_M_firsts)) + (std::get<I>(_M_its) - std::get<I>(_M_firsts))), ...);
+            return n;
         }
 
-        auto end() const
+        template <std::size_t I>
+        void seek_dim(difference_type &n)
+        {
+            if constexpr (I == 0)
+            {
+                std::get<I>(_M_its) = std::get<I>(_M_firsts) + n;
+            }
+            else
+            {
+                difference_type radix = std::get<I>(_M_lasts) - std::get<I>(_M_firsts);
+                std::get<I>(_M_its) = std::get<I>(_M_firsts) + n % radix;
+                n /= radix;
+            }
+        }
+
+        template <std::size_t... I>
+        void seek_impl(difference_type n, std::index_sequence<I...>)
         {
-            return product_iterator<Iterator>(_M_it_last, _M_it_last);
+            // least significant (last) dimension first
+            (seek_dim<N - 1 - I>(n), ...);
         }
 
-    private:
-        Iterator _M_it_first;
-        Iterator _M_it_last;
+        iterators_t _M_its;
+        iterators_t _M_firsts;
+        iterators_t _M_lasts;
     };
 
-    // product_impl general case
-    template <typename Iterator, typename... Iterators>
-    class product_impl<Iterator, Iterators...>
+    template <typename... Iterators>
+    class product_impl : public view_base<product_impl<Iterators...>>
     {
+        using iterators_t = std::tuple<Iterators...>;
+
     public:
-        template <typename... ArgsT>
-        product_impl(Iterator first, Iterator last, ArgsT... rest)
-            : _M_it_first(first), _M_it_last(last), _M_sub_product(rest...) {}
+        product_impl(iterators_t firsts, iterators_t lasts) : _M_firsts(firsts), _M_lasts(lasts) {}
 
         auto begin() const
         {
-            return product_iterator<Iterator, Iterators...>(_M_it_first, _M_it_last, _M_sub_product.begin(), _M_sub_product.begin(), _M_sub_product.end());
+            // the product of anything with an empty iterable is empty
+            if (empty_impl(std::make_index_sequence<sizeof...(Iterators)>()))
+            {
+                return end();
+            }
+            return product_iterator<Iterators...>(_M_firsts, _M_firsts, _M_lasts);
         }
 
         auto end() const
         {
-            return product_iterator<Iterator, Iterators...>(_M_it_last, _M_it_last, _M_sub_product.end(), _M_sub_product.begin(), _M_sub_product.end());
+            iterators_t its = _M_firsts;
+            std::get<0>(its) = std::get<0>(_M_lasts);
+            return product_iterator<Iterators...>(its, _M_firsts, _M_lasts);
+        }
+
+        /// \brief Number of tuples, i.e. the product of the sizes of all iterables.
+        std::size_t size() const
+        {
+            return size_impl(std::make_index_sequence<sizeof...(Iterators)>());
         }
 
     private:
-        Iterator _M_it_first;
-        Iterator _M_it_last;
-        product_impl<Iterators...> _M_sub_product;
+        template <std::size_t... I>
+        bool empty_impl(std::index_sequence<I...>) const
+        {
+            return ((std::get<I>(_M_firsts) == std::get<I>(_M_lasts)) || ...);
+        }
+
+        template <std::size_t... I>
+        std::size_t size_impl(std::index_sequence<I...>) const
+        {
+            return (std::size_t(1) * ... * static_cast<std::size_t>(std::distance(std::get<I>(_M_firsts), std::get<I>(_M_lasts))));
+        }
+
+        iterators_t _M_firsts;
+        iterators_t _M_lasts;
     };
 
     // finally, the product() function
     template <typename... Iterables>
     auto product(Iterables &&... iterables)
     {
-        return std::apply(
-            [&iterables...](auto &&... args) {
-                return product_impl<decltype(iterables.begin())...>(std::forward<decltype(args)>(args)...);
-            },
-            std::tuple_cat(std::make_tuple(iterables.begin(), iterables.end())...));
+        static_assert(sizeof...(Iterables) > 0);
+        return product_impl<decltype(iterables.begin())...>(std::make_tuple(iterables.begin()...), std::make_tuple(iterables.end()...));
     }
 
 } // namespace itertools
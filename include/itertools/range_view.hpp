@@ -22,25 +22,55 @@
  * @file range_view.hpp
  *
  * Wrap iterators [first, last) into an object that has begin() and end().
+ * last may also be a sentinel, an end of another type than first.
+ *
+ * In C++20, the views of this library derive from std::ranges::view_interface, through view_base, so that
+ * they model std::ranges::view and can be composed with std::views.
  */
 
 #pragma once
 
+#include <cstddef>
+#include <utility>
+
+#if __cplusplus > 201703L && __has_include(<ranges>)
+#include <ranges>
+#endif
+
 namespace itertools
 {
-    template <typename Iterator>
-    class range_view
+#if defined(__cpp_lib_ranges)
+    template <typename Derived>
+    struct view_base : std::ranges::view_interface<Derived>
+    {
+    };
+#else
+    template <typename Derived>
+    struct view_base
+    {
+    };
+#endif
+
+    /// \brief The view [first, last); last may be a sentinel of another type (see sentinel.hpp).
+    template <typename Iterator, typename Sentinel = Iterator>
+    class range_view : public view_base<range_view<Iterator, Sentinel>>
     {
     public:
-        range_view(Iterator first, Iterator last) : _M_first(first), _M_last(last) {}
+        range_view() = default;
+
+        range_view(Iterator first, Sentinel last) : _M_first(std::move(first)), _M_last(std::move(last)) {}
 
         Iterator begin() const { return _M_first; }
 
-        Iterator end() const { return _M_last; }
+        Sentinel end() const { return _M_last; }
+
+        /// \brief Number of elements; only for iterators that can be subtracted.
+        template <typename It = Iterator, typename = decltype(std::declval<const Sentinel &>() - std::declval<const It &>())>
+        std::size_t size() const { return _M_last - _M_first; }
 
     private:
         Iterator _M_first;
-        Iterator _M_last;
+        Sentinel _M_last;
     };
 
 } // namespace itertools
@@ -23,28 +23,80 @@
  *
  * Make an iterator that returns object over and over again.
  * Runs indefinitely unless the times argument is specified.
+ *
+ * The value is kept once, in the first iterator: the end is a sentinel, unreachable_sentinel or the
+ * number of times.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
 
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
 #include <utility>
 
 namespace itertools
 {
+    /// \brief How repeat iterators keep their value: a pointer to an lvalue, so that they can be assigned,
+    /// or a copy of an rvalue.
+    template <typename Value>
+    struct repeat_storage
+    {
+        static constexpr bool by_pointer = std::is_lvalue_reference_v<Value>;
+
+        using type = std::conditional_t<by_pointer, std::remove_reference_t<Value> *, Value>;
+
+        using reference = std::conditional_t<by_pointer, Value, const Value &>;
+
+        static type store(Value &&value)
+        {
+            if constexpr (by_pointer)
+            {
+                return &value;
+            }
+            else
+            {
+                return std::move(value);
+            }
+        }
+
+        static reference get(const type &stored)
+        {
+            if constexpr (by_pointer)
+            {
+                return *stored;
+            }
+            else
+            {
+                return stored;
+            }
+        }
+    };
+
     template <typename Value>
     class repeat_inf_iterator
     {
     public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = typename repeat_storage<Value>::reference;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        repeat_inf_iterator() = default;
+
         repeat_inf_iterator(Value &&value)
-            : _M_value(std::forward<Value>(value))
+            : _M_value(repeat_storage<Value>::store(std::forward<Value>(value)))
         {
         }
 
-        Value &operator*() const
+        reference operator*() const
         {
-            return _M_value;
+            return repeat_storage<Value>::get(_M_value);
         }
 
         repeat_inf_iterator &operator++()
@@ -52,32 +104,52 @@ namespace itertools
             return *this;
         }
 
-        bool operator==(const repeat_inf_iterator &other) const
+        repeat_inf_iterator operator++(int)
         {
-            return false;
+            return *this;
         }
 
-        bool operator!=(const repeat_inf_iterator &other) const
+        bool operator==(const repeat_inf_iterator &) const
         {
             return true;
         }
 
+        bool operator!=(const repeat_inf_iterator &) const
+        {
+            return false;
+        }
+
     private:
-        Value _M_value;
+        typename repeat_storage<Value>::type _M_value{};
+    };
+
+    /// \brief The end of repeat(value, times).
+    template <typename N>
+    struct repeat_sentinel
+    {
+        N _M_times{};
     };
 
     template <typename Value, typename N>
     class repeat_iterator
     {
     public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = typename repeat_storage<Value>::reference;
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        repeat_iterator() = default;
+
         repeat_iterator(Value &&value, N times)
-            : _M_value(std::forward<Value>(value)), _M_times(times)
+            : _M_value(repeat_storage<Value>::store(std::forward<Value>(value))), _M_times(times)
         {
         }
 
-        Value &operator*() const
+        reference operator*() const
         {
-            return _M_value;
+            return repeat_storage<Value>::get(_M_value);
         }
 
         repeat_iterator &operator++()
@@ -86,6 +158,13 @@ namespace itertools
             return *this;
         }
 
+        repeat_iterator operator++(int)
+        {
+            repeat_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const repeat_iterator &other) const
         {
             return _M_times == other._M_times;
@@ -96,27 +175,43 @@ namespace itertools
             return !(*this == other);
         }
 
+        friend bool operator==(const repeat_iterator &it, const repeat_sentinel<N> &last)
+        {
+            return it._M_times == last._M_times;
+        }
+
+        friend bool operator==(const repeat_sentinel<N> &last, const repeat_iterator &it)
+        {
+            return it == last;
+        }
+
+        friend bool operator!=(const repeat_iterator &it, const repeat_sentinel<N> &last)
+        {
+            return !(it == last);
+        }
+
+        friend bool operator!=(const repeat_sentinel<N> &last, const repeat_iterator &it)
+        {
+            return !(it == last);
+        }
+
     private:
-        Value _M_value;
-        N _M_times;
+        typename repeat_storage<Value>::type _M_value{};
+        N _M_times{};
     };
 
     template <typename Value>
     auto repeat(Value &&value)
     {
         using it_t = repeat_inf_iterator<Value>;
-        it_t it_first(std::forward<Value>(value));
-        it_t it_last(std::forward<Value>(value));
-        return range_view<it_t>(it_first, it_last);
+        return range_view<it_t, unreachable_sentinel_t>(it_t(std::forward<Value>(value)), unreachable_sentinel);
     }
 
     template <typename Value, typename N>
     auto repeat(Value &&value, N times)
     {
         using it_t = repeat_iterator<Value, N>;
-        it_t it_first(std::forward<Value>(value), 0);
-        it_t it_last(std::forward<Value>(value), times);
-        return range_view<it_t>(it_first, it_last);
+        return range_view<it_t, repeat_sentinel<N>>(it_t(std::forward<Value>(value), 0), repeat_sentinel<N>{times});
     }
 
 } // namespace itertools
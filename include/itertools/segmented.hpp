@@ -0,0 +1,88 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file segmented.hpp
+ *
+ * Iterate a view segment by segment, with a tight loop over each segment.
+ *
+ * Some adaptors, like chain, join several ranges: stepping their iterators has to check at every element
+ * which range it is in. Such iterators can provide the member it.for_each_segment(last, fn), which calls
+ * fn(segment_first, segment_last) for every range between it and last, with the iterators of that range.
+ * for_each_segment(first, last, fn) uses the member when there is one, and calls fn(first, last) otherwise.
+ *
+ * for_each(view, fn) is the internal iteration built on top of it: a plain loop over every segment, that
+ * the compiler can unroll and vectorise as if it were over the ranges themselves.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace itertools
+{
+    template <typename Iterator, typename Fn, typename = void>
+    struct has_segment_members : std::false_type
+    {
+    };
+
+    template <typename Iterator, typename Fn>
+    struct has_segment_members<Iterator, Fn, std::void_t<decltype(std::declval<const Iterator &>().for_each_segment(std::declval<const Iterator &>(), std::declval<Fn &>()))>>
+        : std::true_type
+    {
+    };
+
+    /// \brief Call fn(segment_first, segment_last) for every segment of [first, last), in order; a view
+    /// that ends with a sentinel is a single segment.
+    template <typename Iterator, typename Sentinel, typename Fn>
+    void for_each_segment(const Iterator &first, const Sentinel &last, Fn &&fn)
+    {
+        if constexpr (std::is_same_v<Iterator, Sentinel> && has_segment_members<Iterator, Fn>::value)
+        {
+            first.for_each_segment(last, fn);
+        }
+        else
+        {
+            fn(first, last);
+        }
+    }
+
+    template <typename View, typename Fn>
+    void for_each_segment(View &&view, Fn &&fn)
+    {
+        itertools::for_each_segment(view.begin(), view.end(), fn);
+    }
+
+    /// \brief Call fn on every element of the view, in order, looping over each segment separately.
+    template <typename View, typename Fn>
+    Fn for_each(View &&view, Fn fn)
+    {
+        itertools::for_each_segment(view.begin(), view.end(), [&fn](auto first, auto last) {
+            for (; first != last; ++first)
+            {
+                fn(*first);
+            }
+        });
+        return fn;
+    }
+
+} // namespace itertools
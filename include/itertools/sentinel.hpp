@@ -0,0 +1,167 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sentinel.hpp
+ *
+ * Ends of views that are not positions of the iterators.
+ *
+ * The end of an endless view, like count or cycle, is never reached, and the end of takewhile is wherever
+ * the predicate first fails. Such views return a sentinel from end(): an object of another type, which
+ * only compares with the iterators. The iterators then need not carry what the end test needs, and when
+ * the test is known at compile time, like for unreachable_sentinel, the compiler folds it away.
+ *
+ * Range-based for loops, the views of C++20 and for_each take sentinels. Code that wants the two ends to
+ * be of the same type, like the algorithms of C++17, can wrap a view with common(), whose iterators are
+ * either an iterator or the sentinel of the view. The adaptors do so on their own with the iterables they
+ * are given, e.g. islice(count(0, 1), 0, 10, 1) or zip(count(0, 1), letters).
+ */
+
+#pragma once
+
+#include <itertools/iterator_traits.hpp>
+#include <itertools/range_view.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace itertools
+{
+    /// \brief The end of an endless view: it compares unequal to every iterator.
+    struct unreachable_sentinel_t
+    {
+        template <typename Iterator>
+        friend constexpr bool operator==(const Iterator &, unreachable_sentinel_t)
+        {
+            return false;
+        }
+
+        template <typename Iterator>
+        friend constexpr bool operator==(unreachable_sentinel_t, const Iterator &)
+        {
+            return false;
+        }
+
+        template <typename Iterator>
+        friend constexpr bool operator!=(const Iterator &, unreachable_sentinel_t)
+        {
+            return true;
+        }
+
+        template <typename Iterator>
+        friend constexpr bool operator!=(unreachable_sentinel_t, const Iterator &)
+        {
+            return true;
+        }
+    };
+
+    inline constexpr unreachable_sentinel_t unreachable_sentinel{};
+
+    /// \brief An iterator, or the sentinel of a view, so that both ends of the view have the same type.
+    template <typename Iterator, typename Sentinel>
+    class common_iterator
+    {
+    public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(*std::declval<const Iterator &>());
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        common_iterator() = default;
+
+        common_iterator(Iterator it)
+            : _M_it(it)
+        {
+        }
+
+        common_iterator(Sentinel last)
+            : _M_last(last), _M_is_last(true)
+        {
+        }
+
+        decltype(auto) operator*() const
+        {
+            return *_M_it;
+        }
+
+        common_iterator &operator++()
+        {
+            ++_M_it;
+            return *this;
+        }
+
+        common_iterator operator++(int)
+        {
+            common_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const common_iterator &other) const
+        {
+            if (_M_is_last)
+            {
+                return other._M_is_last || other._M_it == _M_last;
+            }
+            if (other._M_is_last)
+            {
+                return _M_it == other._M_last;
+            }
+            return _M_it == other._M_it;
+        }
+
+        bool operator!=(const common_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Iterator _M_it{};
+        Sentinel _M_last{};
+        bool _M_is_last = false;
+    };
+
+    template <typename Iterable>
+    using common_iterator_t = std::conditional_t<std::is_same_v<decltype(std::declval<Iterable &>().begin()), decltype(std::declval<Iterable &>().end())>,
+                                                 decltype(std::declval<Iterable &>().begin()),
+                                                 common_iterator<decltype(std::declval<Iterable &>().begin()), decltype(std::declval<Iterable &>().end())>>;
+
+    template <typename Iterable>
+    common_iterator_t<Iterable> common_begin(Iterable &iterable)
+    {
+        return common_iterator_t<Iterable>(iterable.begin());
+    }
+
+    template <typename Iterable>
+    common_iterator_t<Iterable> common_end(Iterable &iterable)
+    {
+        return common_iterator_t<Iterable>(iterable.end());
+    }
+
+    /// \brief The view with both ends of the same type: the view itself if they already are.
+    template <typename Iterable>
+    auto common(Iterable &&iterable)
+    {
+        return range_view<common_iterator_t<Iterable>>(common_begin(iterable), common_end(iterable));
+    }
+
+} // namespace itertools
@@ -0,0 +1,160 @@
+
+/** 
+ *  itertools : Iterator building blocks for fast and memory efficient "iterator algebra".
+ *
+ *  Copyright (C) 2020 Hank Meng (ymenghank@gmail.com)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file splittable.hpp
+ *
+ * Cut a view into sub-views of roughly equal work, that keep their order.
+ *
+ * Views are cut through their iterators, with two operations:
+ *
+ * - split_distance(first, last): the amount of work from first to last;
+ * - split_advance(it, n, last): move it by n units of work, but not past last, and return how far it moved.
+ *
+ * Iterators may provide them as the members it.split_distance(last) and it.split_advance(n, last);
+ * this is how the adaptors propagate them to the iterators they wrap. Otherwise, random access iterators
+ * use - and +=, in constant time, and other iterators count with ++, in linear time.
+ */
+
+#pragma once
+
+#include <itertools/range_view.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace itertools
+{
+    template <typename Iterator, typename = void>
+    struct has_split_members : std::false_type
+    {
+    };
+
+    template <typename Iterator>
+    struct has_split_members<Iterator, std::void_t<decltype(std::declval<const Iterator &>().split_distance(std::declval<const Iterator &>()))>>
+        : std::true_type
+    {
+    };
+
+    template <typename Iterator, typename = void>
+    struct is_subtractable : std::false_type
+    {
+    };
+
+    template <typename Iterator>
+    struct is_subtractable<Iterator, std::void_t<decltype(std::declval<const Iterator &>() - std::declval<const Iterator &>()),
+                                                 decltype(std::declval<Iterator &>() += 1)>>
+        : std::true_type
+    {
+    };
+
+    template <typename Iterator>
+    std::ptrdiff_t split_distance(const Iterator &first, const Iterator &last)
+    {
+        if constexpr (has_split_members<Iterator>::value)
+        {
+            return first.split_distance(last);
+        }
+        else if constexpr (is_subtractable<Iterator>::value)
+        {
+            return last - first;
+        }
+        else
+        {
+            std::ptrdiff_t n = 0;
+            for (Iterator it = first; it != last; ++it)
+            {
+                ++n;
+            }
+            return n;
+        }
+    }
+
+    template <typename Iterator>
+    std::ptrdiff_t split_advance(Iterator &it, std::ptrdiff_t n, const Iterator &last)
+    {
+        if constexpr (has_split_members<Iterator>::value)
+        {
+            return it.split_advance(n, last);
+        }
+        else if constexpr (is_subtractable<Iterator>::value)
+        {
+            n = std::min<std::ptrdiff_t>(n, last - it);
+            it += n;
+            return n;
+        }
+        else
+        {
+            std::ptrdiff_t k = 0;
+            for (; k != n && it != last; ++k)
+            {
+                ++it;
+            }
+            return k;
+        }
+    }
+
+    /// \brief Cut a view into [begin, begin + n) and [begin + n, end), in units of work.
+    template <typename View>
+    auto split_at(View &&view, std::ptrdiff_t n)
+    {
+        auto first = view.begin();
+        auto last = view.end();
+        auto mid = first;
+        split_advance(mid, n, last);
+        using view_t = range_view<decltype(first)>;
+        return std::make_pair(view_t(first, mid), view_t(mid, last));
+    }
+
+    /// \brief Cut a view into k consecutive sub-views of roughly equal work (some may be empty if there is little work).
+    template <typename View>
+    auto chunk(View &&view, std::size_t k)
+    {
+        auto first = view.begin();
+        auto last = view.end();
+        using view_t = range_view<decltype(first)>;
+        std::vector<view_t> chunks;
+        chunks.reserve(k);
+        std::ptrdiff_t total = split_distance(first, last);
+        std::ptrdiff_t done = 0;
+        for (std::size_t i = 1; i <= k; ++i)
+        {
+            // iterators are only ever copy constructed, since those holding lambdas cannot be assigned
+            auto it = chunks.empty() ? first : chunks.back().end();
+            if (i == k)
+            {
+                chunks.emplace_back(it, last);
+            }
+            else
+            {
+                std::ptrdiff_t target = total * static_cast<std::ptrdiff_t>(i) / static_cast<std::ptrdiff_t>(k);
+                auto mid = it;
+                done += split_advance(mid, target - done, last);
+                chunks.emplace_back(it, mid);
+            }
+        }
+        return chunks;
+    }
+
+} // namespace itertools
@@ -26,9 +26,15 @@
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 
+#include <cstddef>
+#include <iterator>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace itertools
@@ -36,7 +42,17 @@ namespace itertools
     template <typename Fn, typename Iterator>
     class starmap_iterator
     {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
     public:
+        using iterator_category = view_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(std::apply(std::declval<const Fn &>(), *std::declval<const Iterator &>()));
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        starmap_iterator() = default;
+
         starmap_iterator(Fn fn, Iterator it)
             : _M_fn(fn), _M_it(it)
         {
@@ -44,7 +60,7 @@ namespace itertools
 
         decltype(auto) operator*() const
         {
-            return std::apply(_M_fn, *_M_it);
+            return std::apply(*_M_fn, *_M_it);
         }
 
         starmap_iterator &operator++()
@@ -53,6 +69,104 @@ namespace itertools
             return *this;
         }
 
+        starmap_iterator operator++(int)
+        {
+            starmap_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        starmap_iterator &operator--()
+        {
+            --_M_it;
+            return *this;
+        }
+
+        starmap_iterator operator--(int)
+        {
+            starmap_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        starmap_iterator &operator+=(difference_type n)
+        {
+            _M_it += n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        starmap_iterator &operator-=(difference_type n)
+        {
+            _M_it -= n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        starmap_iterator operator+(difference_type n) const
+        {
+            return starmap_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend starmap_iterator operator+(difference_type n, const starmap_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        starmap_iterator operator-(difference_type n) const
+        {
+            return starmap_iterator(*this) -= n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const starmap_iterator &other) const
+        {
+            return _M_it - other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const starmap_iterator &other) const
+        {
+            return _M_it < other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const starmap_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const starmap_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const starmap_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
+        std::ptrdiff_t split_distance(const starmap_iterator &other) const
+        {
+            return itertools::split_distance(_M_it, other._M_it);
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const starmap_iterator &last)
+        {
+            return itertools::split_advance(_M_it, n, last._M_it);
+        }
+
         bool operator==(const starmap_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -64,7 +178,7 @@ namespace itertools
         }
 
     private:
-        Fn _M_fn;
+        copyable_box<Fn> _M_fn;
         Iterator _M_it;
     };
 
@@ -78,7 +192,7 @@ namespace itertools
     template <typename Fn, typename Iterable>
     auto starmap(Fn fn, Iterable &&iterable)
     {
-        return starmap(fn, iterable.begin(), iterable.end());
+        return starmap(fn, common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
@@ -22,69 +22,65 @@
  * @file takewhile.hpp
  *
  * Make an iterator that returns elements from the iterable as long as the predicate is true.
+ *
+ * The iterators are those of the iterable: the predicate is kept in the end, a takewhile_sentinel, which
+ * an iterator equals when it is at the end of the iterable or at an element for which the predicate fails.
  */
 
 #pragma once
 
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
 
 namespace itertools
 {
     template <typename Fn, typename Iterator>
-    class takewhile_iterator
+    class takewhile_sentinel
     {
     public:
-        takewhile_iterator(Fn fn, Iterator first, Iterator last)
-            : _M_fn(fn), _M_it(first), _M_it_last(last)
-        {
-            next_selected();
-        }
+        takewhile_sentinel() = default;
 
-        void next_selected()
+        takewhile_sentinel(Fn fn, Iterator last)
+            : _M_fn(fn), _M_it_last(last)
         {
-            for (; _M_it != _M_it_last && !_M_fn(*_M_it); ++_M_it)
-                ;
         }
 
-        decltype(auto) operator*() const
+        friend bool operator==(const Iterator &it, const takewhile_sentinel &last)
         {
-            return *_M_it;
+            return it == last._M_it_last || !last._M_fn(*it);
         }
 
-        takewhile_iterator &operator++()
+        friend bool operator==(const takewhile_sentinel &last, const Iterator &it)
         {
-            ++_M_it;
-            next_selected();
-            return *this;
+            return it == last;
         }
 
-        bool operator==(const takewhile_iterator &other) const
+        friend bool operator!=(const Iterator &it, const takewhile_sentinel &last)
         {
-            return _M_it == other._M_it;
+            return !(it == last);
         }
 
-        bool operator!=(const takewhile_iterator &other) const
+        friend bool operator!=(const takewhile_sentinel &last, const Iterator &it)
         {
-            return !(*this == other);
+            return !(it == last);
         }
 
     private:
-        Fn _M_fn;
-        Iterator _M_it;
-        Iterator _M_it_last;
+        copyable_box<Fn> _M_fn;
+        Iterator _M_it_last{};
     };
 
     template <typename Fn, typename Iterator>
     auto takewhile(Fn predicate, Iterator first, Iterator last)
     {
-        using it_t = takewhile_iterator<Fn, Iterator>;
-        return range_view<it_t>(it_t(predicate, first, last), it_t(predicate, last, last));
+        return range_view<Iterator, takewhile_sentinel<Fn, Iterator>>(first, takewhile_sentinel<Fn, Iterator>(predicate, last));
     }
 
     template <typename Fn, typename Iterable>
     auto takewhile(Fn predicate, Iterable &&iterable)
     {
-        return takewhile(predicate, iterable.begin(), iterable.end());
+        return takewhile(predicate, common_begin(iterable), common_end(iterable));
     }
 
 } // namespace itertools
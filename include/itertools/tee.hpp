@@ -18,51 +18,651 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 /**
  * @file tee.hpp
  *
  * Return n independent iterators from a single iterable.
+ *
+ * Like Python's, the iterable is read once: elements are pulled from it by the most advanced of the
+ * n iterators, kept in a ring buffer shared by all of them, and released once the slowest one has
+ * passed them. Memory is bounded by the lag between the first and the last iterator, and upstream
+ * adaptors (starmap, filter, ...) compute each element only once. This also makes tee work over
+ * single-pass input, such as std::istream_iterator.
+ *
+ * concurrent_tee() fans the iterable out to n consumer threads instead: a producer thread reads it
+ * into a lock-free ring of fixed capacity, which every consumer reads in full. The producer waits
+ * when the ring is full, until the slowest consumer has read the oldest element. A thread that waits
+ * spins, then yields, then sleeps on a condition variable, so that a stalled peer costs no CPU.
  */
 
 #pragma once
 
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
 
-#include <tuple>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace itertools
 {
-    template <unsigned N, typename T>
-    struct duplicator;
-
+    /// \brief A queue of T in a circular array, that doubles its capacity when full.
     template <typename T>
-    struct duplicator<0, T>
+    class ring_buffer
     {
-        decltype(auto) get(T &&arg) const
+    public:
+        ring_buffer() = default;
+
+        ring_buffer(const ring_buffer &) = delete;
+
+        ring_buffer &operator=(const ring_buffer &) = delete;
+
+        ~ring_buffer()
+        {
+            while (_M_size != 0)
+            {
+                pop_front();
+            }
+            ::operator delete(_M_data);
+        }
+
+        std::size_t size() const { return _M_size; }
+
+        T &operator[](std::size_t i) { return _M_data[(_M_head + i) & (_M_capacity - 1)]; }
+
+        template <typename... Args>
+        void emplace_back(Args &&... args)
         {
-            return std::tuple<>();
+            if (_M_size == _M_capacity)
+            {
+                grow();
+            }
+            new (&_M_data[(_M_head + _M_size) & (_M_capacity - 1)]) T(std::forward<Args>(args)...);
+            ++_M_size;
         }
+
+        void pop_front()
+        {
+            _M_data[_M_head].~T();
+            _M_head = (_M_head + 1) & (_M_capacity - 1);
+            --_M_size;
+        }
+
+    private:
+        void grow()
+        {
+            std::size_t capacity = _M_capacity == 0 ? 16 : 2 * _M_capacity;
+            T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+            for (std::size_t i = 0; i != _M_size; ++i)
+            {
+                new (&data[i]) T(std::move((*this)[i]));
+                (*this)[i].~T();
+            }
+            ::operator delete(_M_data);
+            _M_data = data;
+            _M_capacity = capacity;
+            _M_head = 0;
+        }
+
+        T *_M_data = nullptr;
+        std::size_t _M_capacity = 0; // zero or a power of two
+        std::size_t _M_head = 0;
+        std::size_t _M_size = 0;
     };
 
-    template <unsigned N, typename T>
-    struct duplicator
+    /// \brief What the iterators of a tee share: the upstream iterators, the buffer, and the cursors.
+    template <typename Iterator, unsigned N>
+    class tee_state
     {
-        decltype(auto) get(T &&arg) const
+    public:
+        using value_type = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator &>())>>;
+
+        tee_state(Iterator first, Iterator last)
+            : _M_it(first), _M_last(last)
+        {
+        }
+
+        /// \brief Whether cursor k has read everything; pulls one element from upstream if needed to tell.
+        bool at_end(unsigned k)
+        {
+            if (_M_cursors[k] != _M_base + _M_buffer.size())
+            {
+                return false;
+            }
+            if (_M_it == _M_last)
+            {
+                return true;
+            }
+            _M_buffer.emplace_back(*_M_it);
+            ++_M_it;
+            return false;
+        }
+
+        /// \brief Element at cursor k, which must not be at_end().
+        const value_type &get(unsigned k)
+        {
+            at_end(k);
+            return _M_buffer[_M_cursors[k] - _M_base];
+        }
+
+        void advance(unsigned k)
+        {
+            at_end(k);
+            bool was_slowest = _M_cursors[k] == _M_base;
+            ++_M_cursors[k];
+            if (was_slowest)
+            {
+                release();
+            }
+        }
+
+        /// \brief Position of cursor k in the iterable.
+        std::uint64_t position(unsigned k) const { return _M_cursors[k]; }
+
+        /// \brief Stop holding elements for cursor k, whose view has gone away.
+        void detach(unsigned k)
+        {
+            _M_cursors[k] = std::numeric_limits<std::uint64_t>::max();
+            release();
+        }
+
+        /// \brief Number of elements held for the slower cursors.
+        std::size_t buffered() const { return _M_buffer.size(); }
+
+    private:
+        /// \brief Drop the elements that every cursor has passed.
+        void release()
         {
-            return std::tuple_cat(std::make_tuple(arg), duplicator<N - 1, T>().get(arg));
+            std::uint64_t slowest = *std::min_element(_M_cursors.begin(), _M_cursors.end());
+            for (; _M_base != slowest && _M_buffer.size() != 0; ++_M_base)
+            {
+                _M_buffer.pop_front();
+            }
         }
+
+        Iterator _M_it;
+        Iterator _M_last;
+        ring_buffer<value_type> _M_buffer;
+        std::uint64_t _M_base = 0; // position of _M_buffer[0] in the iterable
+        std::array<std::uint64_t, N> _M_cursors{};
     };
 
+    /// \brief One of the iterators of a tee. The default constructed one is the end.
+    ///
+    /// The reference returned by operator* is valid until any iterator of the same tee moves. The
+    /// iterators are valid as long as their view.
+    template <typename Iterator, unsigned N>
+    class tee_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename tee_state<Iterator, N>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        tee_iterator() = default;
+
+        tee_iterator(tee_state<Iterator, N> *state, unsigned k)
+            : _M_state(state), _M_k(k)
+        {
+        }
+
+        reference operator*() const
+        {
+            return _M_state->get(_M_k);
+        }
+
+        tee_iterator &operator++()
+        {
+            _M_state->advance(_M_k);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(const tee_iterator &other) const
+        {
+            bool end = at_end();
+            bool other_end = other.at_end();
+            if (end || other_end)
+            {
+                return end == other_end;
+            }
+            return _M_state == other._M_state && _M_state->position(_M_k) == other._M_state->position(other._M_k);
+        }
+
+        bool operator!=(const tee_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        bool at_end() const
+        {
+            return _M_state == nullptr || _M_state->at_end(_M_k);
+        }
+
+        tee_state<Iterator, N> *_M_state = nullptr;
+        unsigned _M_k = 0;
+    };
+
+    /// \brief One of the n views returned by tee(). Its begin() is where it was left at.
+    ///
+    /// The views are move-only: a view that goes away no longer holds elements back for itself.
+    template <typename Iterator, unsigned N>
+    class tee_view : public view_base<tee_view<Iterator, N>>
+    {
+    public:
+        tee_view(std::shared_ptr<tee_state<Iterator, N>> state, unsigned k)
+            : _M_state(std::move(state)), _M_k(k)
+        {
+        }
+
+        tee_view(tee_view &&) = default;
+
+        tee_view &operator=(tee_view &&other)
+        {
+            if (this != &other)
+            {
+                release();
+                _M_state = std::move(other._M_state);
+                _M_k = other._M_k;
+            }
+            return *this;
+        }
+
+        ~tee_view()
+        {
+            release();
+        }
+
+        tee_iterator<Iterator, N> begin() const { return tee_iterator<Iterator, N>(_M_state.get(), _M_k); }
+
+        tee_iterator<Iterator, N> end() const { return tee_iterator<Iterator, N>(); }
+
+        /// \brief Number of elements held for the slower views.
+        std::size_t buffered() const { return _M_state->buffered(); }
+
+    private:
+        void release()
+        {
+            if (_M_state)
+            {
+                _M_state->detach(_M_k);
+                _M_state.reset();
+            }
+        }
+
+        std::shared_ptr<tee_state<Iterator, N>> _M_state;
+        unsigned _M_k;
+    };
+
+    template <unsigned N, typename Iterator, std::size_t... I>
+    std::array<tee_view<Iterator, N>, N> make_tee_views(std::shared_ptr<tee_state<Iterator, N>> state, std::index_sequence<I...>)
+    {
+        return {tee_view<Iterator, N>(state, I)...};
+    }
+
     template <unsigned N, typename Iterator>
     auto tee(Iterator first, Iterator last)
     {
-        return duplicator<N, Iterator>().get(range_view<Iterator>(first, last));
+        auto state = std::make_shared<tee_state<Iterator, N>>(first, last);
+        return make_tee_views<N>(state, std::make_index_sequence<N>());
     }
 
     template <unsigned N, typename Iterable>
     auto tee(Iterable &&iterable)
     {
-        return duplicator<N, Iterable>().get(iterable);
+        return tee<N>(common_begin(iterable), common_end(iterable));
+    }
+
+    /// \brief Spin a few times, then give the core away a few times, while waiting on another thread;
+    /// false once waiting longer should block instead.
+    inline bool backoff(unsigned &spins)
+    {
+        if (++spins < 64)
+        {
+            return true;
+        }
+        if (spins < 128)
+        {
+            std::this_thread::yield();
+            return true;
+        }
+        return false;
+    }
+
+    /// \brief A ring of fixed capacity, written by one producer thread and read in full by each of N consumers.
+    ///
+    /// The producer publishes an element by moving _M_tail, and each consumer frees it by moving its own
+    /// head; no lock is taken while the ring is neither full nor empty. A slot is overwritten only after
+    /// every consumer has moved past it. Consumers that go away set their head to the maximum, and are no
+    /// longer waited for. A thread that has waited too long sleeps until another one calls wake().
+    template <typename Iterator, unsigned N>
+    class concurrent_tee_state
+    {
+    public:
+        using value_type = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator &>())>>;
+
+        concurrent_tee_state(Iterator first, Iterator last, std::size_t capacity)
+            : _M_capacity(round_up(capacity)),
+              _M_slots(static_cast<value_type *>(::operator new(_M_capacity * sizeof(value_type))))
+        {
+            _M_producer = std::thread([this, first, last]() mutable { produce(first, last); });
+        }
+
+        concurrent_tee_state(const concurrent_tee_state &) = delete;
+
+        concurrent_tee_state &operator=(const concurrent_tee_state &) = delete;
+
+        ~concurrent_tee_state()
+        {
+            _M_stop.store(true, std::memory_order_relaxed);
+            wake();
+            _M_producer.join();
+            std::uint64_t tail = _M_tail.load(std::memory_order_relaxed);
+            for (std::uint64_t p = std::max(_M_destroyed, tail > _M_capacity ? tail - _M_capacity : 0); p != tail; ++p)
+            {
+                slot(p).~value_type();
+            }
+            ::operator delete(_M_slots);
+        }
+
+        /// \brief Whether consumer k has read everything; waits for the producer until it can tell.
+        /// Rethrows what the producer threw, once k has read what came before.
+        bool at_end(unsigned k)
+        {
+            std::uint64_t head = _M_heads[k].pos.load(std::memory_order_relaxed);
+            wait_until([&] { return head < _M_tail.load(std::memory_order_acquire) || _M_done.load(std::memory_order_acquire); });
+            // the tail is final once done is set
+            if (head < _M_tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (_M_error)
+            {
+                std::rethrow_exception(_M_error);
+            }
+            return true;
+        }
+
+        /// \brief Element at consumer k, which must not be at_end().
+        const value_type &get(unsigned k)
+        {
+            return slot(_M_heads[k].pos.load(std::memory_order_relaxed));
+        }
+
+        void advance(unsigned k)
+        {
+            at_end(k);
+            _M_heads[k].pos.fetch_add(1, std::memory_order_release);
+            wake();
+        }
+
+        /// \brief Stop waiting for consumer k.
+        void detach(unsigned k)
+        {
+            _M_heads[k].pos.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_release);
+            wake();
+        }
+
+    private:
+        static std::size_t round_up(std::size_t capacity)
+        {
+            std::size_t n = 1;
+            while (n < capacity)
+            {
+                n *= 2;
+            }
+            return n;
+        }
+
+        value_type &slot(std::uint64_t p) { return _M_slots[p & (_M_capacity - 1)]; }
+
+        /// \brief Wait until ready() holds: spin, then yield, then sleep until another thread calls wake().
+        template <typename Ready>
+        void wait_until(Ready ready)
+        {
+            for (unsigned spins = 0; !ready();)
+            {
+                if (!backoff(spins))
+                {
+                    std::unique_lock<std::mutex> lock(_M_mutex);
+                    _M_sleepers.fetch_add(1, std::memory_order_relaxed);
+                    // pairs with the fence in wake(): either it sees the sleeper, or ready() sees its change
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    _M_wakeup.wait(lock, ready);
+                    _M_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+
+        /// \brief Wake the threads sleeping in wait_until(), once what they wait for may have changed.
+        void wake()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_M_sleepers.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard<std::mutex> lock(_M_mutex);
+                _M_wakeup.notify_all();
+            }
+        }
+
+        /// \brief Wait until every consumer has read the element at position p.
+        bool wait_read(std::uint64_t p)
+        {
+            wait_until([&] {
+                if (_M_stop.load(std::memory_order_relaxed))
+                {
+                    return true;
+                }
+                _M_min_head = std::numeric_limits<std::uint64_t>::max();
+                for (auto &head : _M_heads)
+                {
+                    _M_min_head = std::min(_M_min_head, head.pos.load(std::memory_order_acquire));
+                }
+                return _M_min_head > p;
+            });
+            return _M_min_head > p;
+        }
+
+        void produce(Iterator it, Iterator last)
+        {
+            try
+            {
+                for (std::uint64_t tail = 0; it != last && !_M_stop.load(std::memory_order_relaxed); ++it, ++tail)
+                {
+                    if (tail < _M_capacity)
+                    {
+                        new (&slot(tail)) value_type(*it);
+                    }
+                    else
+                    {
+                        // read upstream before waiting, and before the slot is destroyed, in case it throws
+                        value_type value(*it);
+                        if (_M_min_head <= tail - _M_capacity && !wait_read(tail - _M_capacity))
+                        {
+                            break;
+                        }
+                        // marked first, so that the slot is not destroyed again if the move throws
+                        _M_destroyed = tail - _M_capacity + 1;
+                        slot(tail).~value_type();
+                        new (&slot(tail)) value_type(std::move(value));
+                    }
+                    _M_tail.store(tail + 1, std::memory_order_release);
+                    wake();
+                }
+            }
+            catch (...)
+            {
+                _M_error = std::current_exception();
+            }
+            _M_done.store(true, std::memory_order_release);
+            wake();
+        }
+
+        struct alignas(64) cursor
+        {
+            std::atomic<std::uint64_t> pos{0};
+        };
+
+        std::size_t _M_capacity;
+        value_type *_M_slots;
+        std::thread _M_producer;
+        alignas(64) std::atomic<std::uint64_t> _M_tail{0}; // number of elements published
+        std::atomic<bool> _M_done{false};
+        std::atomic<bool> _M_stop{false};
+        std::exception_ptr _M_error;
+        std::uint64_t _M_min_head = 0; // producer's view of the slowest consumer
+        std::uint64_t _M_destroyed = 0; // positions below it have been destroyed by the producer
+        std::array<cursor, N> _M_heads;
+        std::mutex _M_mutex;
+        std::condition_variable _M_wakeup;
+        std::atomic<unsigned> _M_sleepers{0};
+    };
+
+    /// \brief The iterator of a concurrent_tee_view. The default constructed one is the end.
+    template <typename Iterator, unsigned N>
+    class concurrent_tee_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename concurrent_tee_state<Iterator, N>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type &;
+        using pointer = const value_type *;
+
+        concurrent_tee_iterator() = default;
+
+        concurrent_tee_iterator(concurrent_tee_state<Iterator, N> *state, unsigned k)
+            : _M_state(state), _M_k(k)
+        {
+        }
+
+        reference operator*() const
+        {
+            return _M_state->get(_M_k);
+        }
+
+        concurrent_tee_iterator &operator++()
+        {
+            _M_state->advance(_M_k);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(const concurrent_tee_iterator &other) const
+        {
+            return at_end() == other.at_end();
+        }
+
+        bool operator!=(const concurrent_tee_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        bool at_end() const
+        {
+            return _M_state == nullptr || _M_state->at_end(_M_k);
+        }
+
+        concurrent_tee_state<Iterator, N> *_M_state = nullptr;
+        unsigned _M_k = 0;
+    };
+
+    /// \brief One of the n consumers of a concurrent_tee, to be moved to the thread that reads it.
+    ///
+    /// Each view must be read by one thread at a time. Destroying a view, read or not, lets the
+    /// producer go on without it; the producer stops when all the views are destroyed.
+    template <typename Iterator, unsigned N>
+    class concurrent_tee_view : public view_base<concurrent_tee_view<Iterator, N>>
+    {
+    public:
+        concurrent_tee_view(std::shared_ptr<concurrent_tee_state<Iterator, N>> state, unsigned k)
+            : _M_state(std::move(state)), _M_k(k)
+        {
+        }
+
+        concurrent_tee_view(concurrent_tee_view &&) = default;
+
+        concurrent_tee_view &operator=(concurrent_tee_view &&other)
+        {
+            if (this != &other)
+            {
+                release();
+                _M_state = std::move(other._M_state);
+                _M_k = other._M_k;
+            }
+            return *this;
+        }
+
+        ~concurrent_tee_view()
+        {
+            release();
+        }
+
+        concurrent_tee_iterator<Iterator, N> begin() const { return concurrent_tee_iterator<Iterator, N>(_M_state.get(), _M_k); }
+
+        concurrent_tee_iterator<Iterator, N> end() const { return concurrent_tee_iterator<Iterator, N>(); }
+
+    private:
+        void release()
+        {
+            if (_M_state)
+            {
+                _M_state->detach(_M_k);
+                _M_state.reset();
+            }
+        }
+
+        std::shared_ptr<concurrent_tee_state<Iterator, N>> _M_state;
+        unsigned _M_k;
+    };
+
+    template <unsigned N, typename Iterator, std::size_t... I>
+    std::array<concurrent_tee_view<Iterator, N>, N> make_concurrent_tee_views(std::shared_ptr<concurrent_tee_state<Iterator, N>> state, std::index_sequence<I...>)
+    {
+        return {concurrent_tee_view<Iterator, N>(state, I)...};
+    }
+
+    /// \brief Read [first, last) once on a new producer thread, and hand every element to each of N views,
+    /// with at most capacity (rounded up to a power of two) elements in flight.
+    ///
+    /// The iterators are used by the producer thread only; what they refer to must outlive the views.
+    template <unsigned N, typename Iterator>
+    auto concurrent_tee(Iterator first, Iterator last, std::size_t capacity = 1024)
+    {
+        auto state = std::make_shared<concurrent_tee_state<Iterator, N>>(first, last, capacity);
+        return make_concurrent_tee_views<N>(state, std::make_index_sequence<N>());
+    }
+
+    template <unsigned N, typename Iterable>
+    auto concurrent_tee(Iterable &&iterable, std::size_t capacity = 1024)
+    {
+        return concurrent_tee<N>(common_begin(iterable), common_end(iterable), capacity);
     }
 
 } // namespace itertools
@@ -26,30 +26,105 @@
  * 
  * The .__next__() method continues until the shortest iterable in the argument sequence
  * is exhausted and then it raises StopIteration.
+ *
+ * The tuples hold what the iterators dereference to: references into the iterables, through which
+ * elements may be written, rather than copies.
+ *
+ * When all the iterables have random access iterators, so does the zip: its end is computed from
+ * the shortest iterable, and the view has a size(). Its elements are zip_reference proxies, which can
+ * be swapped and assigned, so that std::sort and std::stable_sort sort all the iterables together;
+ * apply_permutation() reorders them by a permutation.
  */
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
+#include <itertools/sentinel.hpp>
+#include <itertools/splittable.hpp>
 
 namespace itertools
 {
+    /// \brief Random access if all members are; otherwise at most forward, since the members of an end
+    /// iterator are not aligned and it cannot be moved back.
+    template <typename... Iterators>
+    using zip_iterator_category_t = view_iterator_category_t<Iterators...>;
+
+    /// \brief What a zip iterator dereferences to: a tuple of references to the elements.
+    ///
+    /// Assigning a zip_reference or a tuple of values writes to the elements; assigning from another
+    /// zip_reference copies, never moves, since it cannot tell std::move(*it) from *it. swap() swaps the
+    /// elements themselves, which is what std::iter_swap, and so std::sort, use.
+    template <typename... Refs>
+    class zip_reference : public std::tuple<Refs...>
+    {
+    public:
+        using std::tuple<Refs...>::tuple;
+        using std::tuple<Refs...>::operator=;
+
+        zip_reference(const std::tuple<Refs...> &refs)
+            : std::tuple<Refs...>(refs)
+        {
+        }
+
+        friend void swap(zip_reference a, zip_reference b)
+        {
+            a.swap_elements(b, std::index_sequence_for<Refs...>());
+        }
+
+    private:
+        template <std::size_t... I>
+        void swap_elements(zip_reference &other, std::index_sequence<I...>)
+        {
+            using std::swap;
+            (swap(std::get<I>(*this), std::get<I>(other)), ...);
+        }
+    };
+
     template <typename... Iterator>
     class zip_iterator;
 
     template <typename Iterator>
     class zip_iterator<Iterator>
     {
+        static constexpr bool random_access = all_random_access<Iterator>();
+
     public:
+        using iterator_category = zip_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = zip_reference<decltype(*std::declval<const Iterator &>())>;
+        using value_type = std::tuple<std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<const Iterator &>())>>>;
+        using pointer = void;
+
+        zip_iterator() = default;
+
         zip_iterator(Iterator first)
             : _M_it(first)
         {
         }
 
-        decltype(auto) operator*() const
+        reference operator*() const
+        {
+            return refs();
+        }
+
+        std::tuple<decltype(*std::declval<const Iterator &>())> refs() const
+        {
+            return std::tuple<decltype(*_M_it)>(*_M_it);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        reference operator[](difference_type n) const
         {
-            return std::make_tuple(*_M_it);
+            return *(*this + n);
         }
 
         zip_iterator &operator++()
@@ -58,6 +133,98 @@ namespace itertools
             return *this;
         }
 
+        zip_iterator operator++(int)
+        {
+            zip_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        zip_iterator &operator--()
+        {
+            --_M_it;
+            return *this;
+        }
+
+        zip_iterator operator--(int)
+        {
+            zip_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator &operator+=(difference_type n)
+        {
+            _M_it += n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator &operator-=(difference_type n)
+        {
+            _M_it -= n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator operator+(difference_type n) const
+        {
+            return zip_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend zip_iterator operator+(difference_type n, const zip_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator operator-(difference_type n) const
+        {
+            return zip_iterator(*this) -= n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const zip_iterator &other) const
+        {
+            return _M_it - other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const zip_iterator &other) const
+        {
+            return _M_it < other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const zip_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const zip_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const zip_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
+        std::ptrdiff_t split_distance(const zip_iterator &other) const
+        {
+            return itertools::split_distance(_M_it, other._M_it);
+        }
+
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const zip_iterator &last)
+        {
+            return itertools::split_advance(_M_it, n, last._M_it);
+        }
+
         bool operator==(const zip_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -75,15 +242,37 @@ namespace itertools
     template <typename Iterator, typename... Iterators>
     class zip_iterator<Iterator, Iterators...>
     {
+        static constexpr bool random_access = all_random_access<Iterator, Iterators...>();
+
     public:
+        using iterator_category = zip_iterator_category_t<Iterator, Iterators...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = zip_reference<decltype(*std::declval<const Iterator &>()), decltype(*std::declval<const Iterators &>())...>;
+        using value_type = std::tuple<std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<const Iterator &>())>>,
+                                      std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<const Iterators &>())>>...>;
+        using pointer = void;
+
+        zip_iterator() = default;
+
         zip_iterator(Iterator first, Iterators... rest)
             : _M_it(first), _M_sub_it(rest...)
         {
         }
 
-        decltype(auto) operator*() const
+        reference operator*() const
+        {
+            return refs();
+        }
+
+        std::tuple<decltype(*std::declval<const Iterator &>()), decltype(*std::declval<const Iterators &>())...> refs() const
+        {
+            return std::tuple_cat(std::tuple<decltype(*_M_it)>(*_M_it), _M_sub_it.refs());
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        reference operator[](difference_type n) const
         {
-            return std::tuple_cat(std::make_tuple(*_M_it), *_M_sub_it);
+            return *(*this + n);
         }
 
         zip_iterator &operator++()
@@ -93,6 +282,105 @@ namespace itertools
             return *this;
         }
 
+        zip_iterator operator++(int)
+        {
+            zip_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        zip_iterator &operator--()
+        {
+            --_M_it;
+            --_M_sub_it;
+            return *this;
+        }
+
+        zip_iterator operator--(int)
+        {
+            zip_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator &operator+=(difference_type n)
+        {
+            _M_it += n;
+            _M_sub_it += n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator &operator-=(difference_type n)
+        {
+            _M_it -= n;
+            _M_sub_it -= n;
+            return *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator operator+(difference_type n) const
+        {
+            return zip_iterator(*this) += n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        friend zip_iterator operator+(difference_type n, const zip_iterator &it)
+        {
+            return it + n;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        zip_iterator operator-(difference_type n) const
+        {
+            return zip_iterator(*this) -= n;
+        }
+
+        /// \brief Members move together, so the first one tells the distance.
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        difference_type operator-(const zip_iterator &other) const
+        {
+            return _M_it - other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<(const zip_iterator &other) const
+        {
+            return _M_it < other._M_it;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>(const zip_iterator &other) const
+        {
+            return other < *this;
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator<=(const zip_iterator &other) const
+        {
+            return !(other < *this);
+        }
+
+        template <bool RA = random_access, typename = std::enable_if_t<RA>>
+        bool operator>=(const zip_iterator &other) const
+        {
+            return !(*this < other);
+        }
+
+        /// \brief The shortest of the distances of the members.
+        std::ptrdiff_t split_distance(const zip_iterator &other) const
+        {
+            return std::min(itertools::split_distance(_M_it, other._M_it), _M_sub_it.split_distance(other._M_sub_it));
+        }
+
+        /// \brief Once a member stops short, the others only move as far; members left ahead
+        /// of it do not matter, since the zip then compares equal to last.
+        std::ptrdiff_t split_advance(std::ptrdiff_t n, const zip_iterator &last)
+        {
+            return _M_sub_it.split_advance(itertools::split_advance(_M_it, n, last._M_it), last._M_sub_it);
+        }
+
         bool operator==(const zip_iterator &other) const
         {
             return _M_it == other._M_it || _M_sub_it == other._M_sub_it;
@@ -111,8 +399,73 @@ namespace itertools
     template <typename... Iterables>
     auto zip(Iterables &&... iterables)
     {
-        using it_t = zip_iterator<decltype(iterables.begin())...>;
-        return range_view<it_t>(it_t(iterables.begin()...), it_t(iterables.end()...));
+        using it_t = zip_iterator<common_iterator_t<Iterables>...>;
+        if constexpr (all_random_access<common_iterator_t<Iterables>...>())
+        {
+            // stop all the members together at the length of the shortest iterable
+            std::ptrdiff_t n = std::min({static_cast<std::ptrdiff_t>(iterables.end() - iterables.begin())...});
+            it_t first(iterables.begin()...);
+            return range_view<it_t>(first, first + n);
+        }
+        else
+        {
+            // iterables that end with a sentinel, like count(), are wrapped in common_iterator
+            return range_view<it_t>(it_t(common_begin(iterables)...), it_t(common_end(iterables)...));
+        }
+    }
+
+    /// \brief Reorder a random access view in place, so that its element i becomes its element perm[i].
+    ///
+    /// The elements are only swapped, following the cycles of the permutation. Over a zip, this reorders
+    /// every iterable the same way; sorting a permutation of indices then applying it moves no element
+    /// more than once. Throws std::invalid_argument if perm is not a permutation of [0, size).
+    template <typename View, typename Permutation>
+    void apply_permutation(View &&view, const Permutation &perm)
+    {
+        auto first = view.begin();
+        std::size_t n = view.end() - first;
+        if (static_cast<std::size_t>(perm.size()) != n)
+        {
+            throw std::invalid_argument("apply_permutation() permutation has the wrong size");
+        }
+        std::vector<bool> done(n);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            std::size_t p = static_cast<std::size_t>(perm[i]);
+            if (p >= n || done[p])
+            {
+                throw std::invalid_argument("apply_permutation() argument is not a permutation");
+            }
+            done[p] = true;
+        }
+        done.assign(n, false);
+        using std::swap;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            if (done[i])
+            {
+                continue;
+            }
+            done[i] = true;
+            for (std::size_t j = i; static_cast<std::size_t>(perm[j]) != i; j = perm[j])
+            {
+                swap(first[j], first[perm[j]]);
+                done[perm[j]] = true;
+            }
+        }
     }
 
 } // namespace itertools
+
+namespace std
+{
+    template <typename... Refs>
+    struct tuple_size<itertools::zip_reference<Refs...>> : tuple_size<tuple<Refs...>>
+    {
+    };
+
+    template <size_t I, typename... Refs>
+    struct tuple_element<I, itertools::zip_reference<Refs...>> : tuple_element<I, tuple<Refs...>>
+    {
+    };
+} // namespace std
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <tuple>
+#include <itertools/iterator_traits.hpp>
 #include <itertools/range_view.hpp>
 
 namespace itertools
@@ -39,9 +42,17 @@ namespace itertools
     template <typename Iterator>
     class zip_longest_iterator<Iterator>
     {
-        using value_type = typename std::remove_reference<decltype(*Iterator())>::type;
+        using element_t = typename std::remove_reference<decltype(*Iterator())>::type;
 
     public:
+        using iterator_category = forward_iterator_category_t<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(std::make_tuple(std::declval<element_t>()));
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        zip_longest_iterator() = default;
+
         zip_longest_iterator(Iterator first, Iterator last)
             : _M_it(first), _M_it_last(last)
         {
@@ -49,7 +60,7 @@ namespace itertools
 
         decltype(auto) operator*() const
         {
-            return _M_it != _M_it_last ? std::make_tuple(*_M_it) : value_type();
+            return _M_it != _M_it_last ? std::make_tuple(*_M_it) : element_t();
         }
 
         zip_longest_iterator &operator++()
@@ -61,6 +72,13 @@ namespace itertools
             return *this;
         }
 
+        zip_longest_iterator operator++(int)
+        {
+            zip_longest_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const zip_longest_iterator &other) const
         {
             return _M_it == other._M_it;
@@ -79,9 +97,17 @@ namespace itertools
     template <typename Iterator, typename... Iterators>
     class zip_longest_iterator<Iterator, Iterators...>
     {
-        using value_type = typename std::remove_reference<decltype(*Iterator())>::type;
+        using element_t = typename std::remove_reference<decltype(*Iterator())>::type;
 
     public:
+        using iterator_category = forward_iterator_category_t<Iterator, Iterators...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(std::tuple_cat(std::make_tuple(std::declval<element_t>()), *std::declval<const zip_longest_iterator<Iterators...> &>()));
+        using value_type = value_type_of_t<reference>;
+        using pointer = void;
+
+        zip_longest_iterator() = default;
+
         template <typename... Args>
         zip_longest_iterator(Iterator first, Iterator last, Args... rest)
             : _M_it(first), _M_it_last(last), _M_sub_it(rest...)
@@ -90,7 +116,7 @@ namespace itertools
 
         decltype(auto) operator*() const
         {
-            return std::tuple_cat(_M_it != _M_it_last ? std::make_tuple(*_M_it) : value_type(), *_M_sub_it);
+            return std::tuple_cat(_M_it != _M_it_last ? std::make_tuple(*_M_it) : element_t(), *_M_sub_it);
         }
 
         zip_longest_iterator &operator++()
@@ -103,6 +129,13 @@ namespace itertools
             return *this;
         }
 
+        zip_longest_iterator operator++(int)
+        {
+            zip_longest_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
         bool operator==(const zip_longest_iterator &other) const
         {
             return _M_it == other._M_it && _M_sub_it == other._M_sub_it;
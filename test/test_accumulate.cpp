@@ -1,8 +1,10 @@
 
 #include <itertools/accumulate.hpp>
 
+#include <functional>
 #include <vector>
 #include <iostream>
+#include <list>
 
 void test_accumulate(std::vector<int> &&nums)
 {
@@ -14,11 +16,51 @@ void test_accumulate(std::vector<int> &&nums)
     std::cout << "]" << std::endl;
 }
 
+void test_accumulate_into(std::size_t n)
+{
+    std::vector<long long> nums(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        nums[i] = static_cast<long long>(i * 7919 % 1000) - 500;
+    }
+
+    std::vector<long long> lazy;
+    for (auto s : itertools::accumulate(nums, 3LL))
+    {
+        lazy.push_back(s);
+    }
+    lazy.resize(n);
+
+    std::vector<long long> seq(n), par(n), generic(n);
+    itertools::accumulate_into(nums.begin(), nums.end(), seq.begin(), 3LL);
+    itertools::parallel::thread_pool pool(4);
+    itertools::accumulate_into(nums.begin(), nums.end(), par.begin(), 3LL, std::plus<>(), itertools::parallel::par.on(pool));
+    std::list<long long> l(nums.begin(), nums.end());
+    itertools::accumulate_into(l.begin(), l.end(), generic.begin(), 3LL, [](long long a, long long b) { return a + b; }, itertools::parallel::par.on(pool));
+
+    std::cout << n << ": " << (seq == lazy) << (par == lazy) << (generic == lazy)
+              << " " << (n ? par.back() : 0) << std::endl;
+}
+
+void test_accumulate_into_narrow()
+{
+    // std::plus<short> narrows every sum, so the int kernel must not be used
+    std::vector<int> nums(8, 30000), out(8);
+    itertools::accumulate_into(nums.begin(), nums.end(), out.begin(), 0, std::plus<short>());
+    std::cout << out[1] << std::endl; // -5536
+}
+
 int main()
 {
     test_accumulate({1, 2, 3, 4, 5});
     test_accumulate({});
     test_accumulate({1});
 
+    test_accumulate_into(0);
+    test_accumulate_into(5);
+    test_accumulate_into(1000003);
+
+    test_accumulate_into_narrow();
+
     return 0;
 }
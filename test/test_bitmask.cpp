@@ -0,0 +1,64 @@
+#include <itertools/bitmask.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <vector>
+
+void test_masks()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::uint8_t> bytes(64);
+    bytes[0] = bytes[5] = bytes[63] = 1;
+    std::uint64_t mask = itertools::nonzero_mask(bytes.data(), 64);
+    for (; mask; mask &= mask - 1)
+    {
+        std::cout << itertools::countr_zero(mask) << " ";
+    }
+    std::cout << std::endl; // 0 5 63
+
+    std::vector<int> nums{5, -1, 7, -3, 0};
+    auto negative = [](int x) { return x < 0; };
+    std::cout << itertools::predicate_mask(nums.data(), nums.size(), negative) << std::endl; // 0b01010 = 10
+}
+
+void test_traits()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::cout << itertools::is_blockable_iterator<int *>()
+              << itertools::is_blockable_iterator<std::vector<char>::const_iterator>()
+              << itertools::is_blockable_iterator<std::vector<double>::const_iterator>()
+              << itertools::is_blockable_iterator<std::vector<bool>::iterator>()
+              << itertools::is_blockable_iterator<std::list<int>::iterator>() << std::endl; // 11000
+}
+
+void test_find_next_set()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::uint64_t words[3] = {0, std::uint64_t(1) << 7, ~std::uint64_t(0)};
+    itertools::bitmask_view bits(words, 130); // bits of the last word past 130 are ignored
+    for (std::size_t i = bits.find_next(0); i != bits.size(); i = bits.find_next(i + 1))
+    {
+        std::cout << i << " ";
+    }
+    std::cout << std::endl; // 71 128 129
+
+    std::vector<bool> bools(200);
+    bools[3] = bools[199] = true;
+    std::cout << itertools::find_next_set(bools, 0) << " " << itertools::find_next_set(bools, 4) << " "
+              << itertools::find_next_set(bools, 200) << std::endl; // 3 199 200
+}
+
+int main()
+{
+    test_masks();
+
+    test_find_next_set();
+
+    test_traits();
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <itertools/cache.hpp>
+#include <itertools/product.hpp>
+#include <itertools/starmap.hpp>
+
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+void test_cache()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(100);
+    std::iota(nums.begin(), nums.end(), 0);
+    int calls = 0;
+    auto sums = itertools::cache(itertools::starmap([&calls](int a, int b) { ++calls; return a + b; }, itertools::product(nums, nums)));
+
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        long total = 0;
+        for (auto s : sums)
+        {
+            total += s;
+        }
+        std::cout << "pass " << pass << ": " << total << " calls " << calls << std::endl; // 990000, calls 10000
+    }
+}
+
+void test_cache_lazy()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::tuple<std::string>> words{{"a"}, {"bb"}, {"ccc"}, {"dddd"}};
+    int calls = 0;
+    auto lengths = itertools::cache(itertools::starmap([&calls](const std::string &w) { ++calls; return w.size(); }, words));
+    auto it = lengths.begin();
+    const std::size_t &first = *it;
+    ++it;
+    std::cout << *it << " cached " << lengths.cached() << " calls " << calls << std::endl; // 2 cached 2 calls 2
+
+    auto again = lengths.begin();
+    std::cout << *again << " " << (&*again == &first) << " calls " << calls << std::endl; // 1 1 calls 2
+}
+
+void test_cache_stable()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::string> words(10000, "word");
+    auto cached = itertools::cache(words);
+    const std::string *first = &*cached.begin();
+    std::size_t n = 0;
+    for (auto &w : cached)
+    {
+        n += w.size();
+    }
+    std::cout << n << " " << (first == &*cached.begin()) << std::endl; // 40000 1
+}
+
+void test_cache_retry()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    // the first evaluation throws after the first chunk was allocated; the retry must fill that chunk
+    std::vector<std::tuple<int>> nums{{7}, {8}, {9}};
+    bool thrown = false;
+    auto values = itertools::cache(itertools::starmap([&thrown](int x) {
+        if (!thrown)
+        {
+            thrown = true;
+            throw std::runtime_error("upstream");
+        }
+        return std::to_string(x);
+    },
+                                                      nums));
+    try
+    {
+        values.begin() != values.end();
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    for (auto &x : values)
+    {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl; // 7 8 9
+}
+
+int main()
+{
+    test_cache();
+
+    test_cache_lazy();
+
+    test_cache_stable();
+
+    test_cache_retry();
+
+    return 0;
+}
@@ -1,10 +1,13 @@
 
 #include <itertools/chain.hpp>
+#include <itertools/parallel.hpp>
 #include <itertools/range_view.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <list>
+#include <utility>
 
 using namespace std;
 
@@ -33,11 +36,80 @@ void test_chain()
     }
 }
 
+void test_chain_from_iterable()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    vector<vector<int>> shards{{}, {1, 2}, {}, {}, {3}, {4, 5, 6}, {}};
+    for (auto i : itertools::chain_from_iterable(shards))
+    {
+        std::cout << i << " ";
+    }
+    std::cout << std::endl; // 1 2 3 4 5 6
+
+    list<list<int>> lists{{1}, {}, {2, 3}};
+    for (auto i : itertools::chain_from_iterable(lists))
+    {
+        std::cout << i << " ";
+    }
+    std::cout << std::endl; // 1 2 3
+
+    // over lists there is no table of starts, so no size() and no subtraction either
+    using list_chain = decltype(itertools::chain_from_iterable(lists));
+    static_assert(!itertools::is_subtractable<decltype(std::declval<list_chain &>().begin())>::value);
+
+    vector<vector<int>> none{{}, {}};
+    auto empty = itertools::chain_from_iterable(none);
+    std::cout << (empty.begin() == empty.end()) << " " << empty.size() << std::endl; // 1 0
+}
+
+void test_chain_from_iterable_random_access()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    vector<vector<int>> shards{{1, 3, 5}, {}, {7}, {9, 11, 13, 15}, {}};
+    auto all = itertools::chain_from_iterable(shards);
+    std::cout << all.size() << " " << all.begin()[3] << " " << *(all.end() - 1) << std::endl; // 8 7 15
+
+    auto it = std::lower_bound(all.begin(), all.end(), 10);
+    std::cout << *it << " at " << (it - all.begin()) << std::endl; // 11 at 5
+
+    std::reverse(all.begin(), all.end());
+    std::cout << shards[0][0] << " " << shards[2][0] << " " << shards[3][3] << std::endl; // 15 9 1
+}
+
+void test_chain_from_iterable_split()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    vector<vector<long>> shards;
+    list<vector<long>> shard_list;
+    for (long k = 0; k < 100; ++k)
+    {
+        shards.emplace_back(k % 7 == 0 ? 0 : 1000, k);
+        shard_list.push_back(shards.back());
+    }
+    itertools::parallel::thread_pool pool(4);
+    auto sum = itertools::parallel::reduce(pool, itertools::chain_from_iterable(shards), 0L, std::plus<>());
+    auto list_sum = itertools::parallel::reduce(pool, itertools::chain_from_iterable(shard_list), 0L, std::plus<>());
+    std::cout << sum << " " << list_sum << std::endl; // 4215000 4215000
+
+    long segments = 0;
+    itertools::for_each_segment(itertools::chain_from_iterable(shards), [&segments](auto, auto) { ++segments; });
+    std::cout << segments << std::endl; // 99
+}
+
 int main()
 {
     test_chain_iterator();
 
     test_chain();
 
+    test_chain_from_iterable();
+
+    test_chain_from_iterable_random_access();
+
+    test_chain_from_iterable_split();
+
     return 0;
 }
@@ -3,6 +3,7 @@
 #include <itertools/range_view.hpp>
 
 #include <iostream>
+#include <numeric>
 #include <vector>
 #include <string>
 
@@ -54,11 +55,87 @@ void test_combinations()
     }
 }
 
+void test_combinations_runtime_r()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector nums{1, 2, 3, 4, 5};
+
+    for (std::size_t r : {0, 1, 3, 5, 6})
+    {
+        std::cout << "5 choose " << r << ": " << std::endl;
+        for (auto &&c : itertools::combinations(nums, r))
+        {
+            for (auto n : c)
+            {
+                std::cout << n << " ";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+void test_combinations_random_access()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(20);
+    std::iota(nums.begin(), nums.end(), 0);
+
+    auto view = itertools::combinations<4>(nums);
+    std::cout << "size: " << view.size() << std::endl; // 4845
+
+    // seeking must agree with stepping
+    std::ptrdiff_t k = 0;
+    for (auto it = view.begin(); it != view.end(); ++it, ++k)
+    {
+        if (view.begin() + k != it || it - view.begin() != k || view.end() - it != static_cast<std::ptrdiff_t>(view.size()) - k)
+        {
+            std::cout << "mismatch at " << k << std::endl;
+        }
+    }
+
+    auto [a, b, c, d] = view.begin()[1000];
+    std::cout << "combination 1000: " << a << " " << b << " " << c << " " << d << std::endl;
+
+    auto dynamic_view = itertools::combinations(nums, 4);
+    std::cout << "dynamic size: " << dynamic_view.size() << std::endl;
+    std::cout << "dynamic combination 1000:";
+    auto dynamic_it = dynamic_view.begin() + 1000;
+    for (auto n : *dynamic_it)
+    {
+        std::cout << " " << n;
+    }
+    std::cout << std::endl;
+
+    std::cout << "nth_combination 1000:";
+    for (auto n : itertools::nth_combination(nums, 4, 1000))
+    {
+        std::cout << " " << n;
+    }
+    std::cout << std::endl;
+
+    std::cout << "combination_rank: " << itertools::combination_rank(nums, std::vector<int>{a, b, c, d}) << std::endl;
+}
+
+void test_combinations_references()
+{
+    std::vector<std::string> words{"a", "b", "c"};
+    auto [first, second] = *itertools::combinations<2>(words).begin();
+    std::cout << (&first == &words[0]) << (&second == &words[1]) << std::endl; // 11
+}
+
 int main()
 {
     test_combinations_iterator();
 
     test_combinations();
 
+    test_combinations_runtime_r();
+
+    test_combinations_random_access();
+
+    test_combinations_references();
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <itertools/combinations_with_replacement.hpp>
 
 #include <iostream>
+#include <numeric>
 #include <vector>
 
 void test_combinations_with_replacement()
@@ -36,9 +37,68 @@ void test_combinations_with_replacement()
     }
 }
 
+void test_combinations_with_replacement_runtime_r()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector nums{1, 2, 3};
+
+    for (std::size_t r : {0, 1, 2, 3, 4})
+    {
+        std::cout << "3 choose " << r << ": " << std::endl;
+        for (auto &&c : itertools::combinations_with_replacement(nums, r))
+        {
+            for (std::size_t i = 0; i != c.size(); ++i)
+            {
+                std::cout << c[i] << " ";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+void test_combinations_with_replacement_random_access()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(10);
+    std::iota(nums.begin(), nums.end(), 0);
+
+    auto view = itertools::combinations_with_replacement<3>(nums);
+    std::cout << "size: " << view.size() << std::endl; // 220
+
+    // seeking must agree with stepping
+    std::ptrdiff_t k = 0;
+    for (auto it = view.begin(); it != view.end(); ++it, ++k)
+    {
+        if (view.begin() + k != it || it - view.begin() != k || view.end() - it != static_cast<std::ptrdiff_t>(view.size()) - k)
+        {
+            std::cout << "mismatch at " << k << std::endl;
+        }
+    }
+
+    auto [a, b, c] = view.begin()[100];
+    std::cout << "combination 100: " << a << " " << b << " " << c << std::endl;
+
+    std::cout << "dynamic size: " << itertools::combinations_with_replacement(nums, 3).size() << std::endl;
+
+    std::cout << "nth_combination_with_replacement 100:";
+    for (auto n : itertools::nth_combination_with_replacement(nums, 3, 100))
+    {
+        std::cout << " " << n;
+    }
+    std::cout << std::endl;
+
+    std::cout << "combination_with_replacement_rank: " << itertools::combination_with_replacement_rank(nums, std::vector<int>{a, b, c}) << std::endl;
+}
+
 int main()
 {
     test_combinations_with_replacement();
 
+    test_combinations_with_replacement_runtime_r();
+
+    test_combinations_with_replacement_random_access();
+
     return 0;
 }
@@ -1,6 +1,8 @@
 
 #include <itertools/compress.hpp>
 
+#include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -14,6 +16,90 @@ void test_compress(std::vector<int> &&ints, std::vector<bool> &&selectors)
     std::cout << "]" << std::endl;
 }
 
+template <typename Selector>
+void test_compress_blocked(std::size_t n, std::size_t m)
+{
+    std::vector<int> data(n);
+    std::vector<Selector> selectors(m);
+    std::vector<bool> bools(m);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        data[i] = static_cast<int>(i);
+    }
+    for (std::size_t i = 0; i < m; ++i)
+    {
+        selectors[i] = bools[i] = (i * 7919 % 100 < 3);
+    }
+
+    // std::vector<bool> is not contiguous, so it goes through the plain iterator
+    std::vector<int> blocked, plain;
+    for (auto e : itertools::compress(data, selectors))
+    {
+        blocked.push_back(e);
+    }
+    for (auto e : itertools::compress(data, bools))
+    {
+        plain.push_back(e);
+    }
+    std::cout << n << " " << m << ": " << blocked.size() << " " << (blocked.empty() ? -1 : blocked.back()) << " " << (blocked == plain) << std::endl;
+}
+
+void test_compress_packed()
+{
+    std::vector<int> data(300);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<int>(i);
+    }
+
+    std::vector<std::uint64_t> words(5, 0); // 320 bits, more than there is data
+    words[0] = 0b1001;
+    words[3] = std::uint64_t(1) << 63;
+    words[4] = 1; // bit 256
+    std::cout << "[";
+    for (auto e : itertools::compress(data, itertools::bitmask_view(words.data(), 320)))
+    {
+        std::cout << e << " ";
+    }
+    std::cout << "]" << std::endl; // [0 3 255 256 ]
+
+    std::bitset<200> bits;
+    bits[1] = bits[130] = bits[199] = true;
+    std::cout << "[";
+    for (auto e : itertools::compress(data, bits))
+    {
+        std::cout << e << " ";
+    }
+    std::cout << "]" << std::endl; // [1 130 199 ]
+
+    std::vector<bool> bools(1000);
+    bools[64] = bools[299] = bools[300] = true; // 300 is past the data
+    std::cout << "[";
+    for (auto e : itertools::compress(data, bools))
+    {
+        std::cout << e << " ";
+    }
+    std::cout << "]" << std::endl; // [64 299 ]
+
+    std::vector<bool> shrunk(200);
+    shrunk[3] = shrunk[70] = shrunk[150] = true;
+    shrunk.resize(100); // the bit of 150 may be left in the storage
+    std::cout << "[";
+    for (auto e : itertools::compress(data, shrunk))
+    {
+        std::cout << e << " ";
+    }
+    std::cout << "]" << std::endl; // [3 70 ]
+
+    std::bitset<64> none;
+    std::cout << "[";
+    for (auto e : itertools::compress(data, none))
+    {
+        std::cout << e << " ";
+    }
+    std::cout << "]" << std::endl; // []
+}
+
 int main()
 {
     test_compress({}, {});
@@ -23,5 +109,14 @@ int main()
     test_compress({1, 2, 3, 4}, {false, true, false});
     test_compress({1, 2, 3,}, {false, true, false, true});
 
+    test_compress_blocked<std::uint8_t>(0, 0);
+    test_compress_blocked<std::uint8_t>(100, 64);
+    test_compress_blocked<std::uint8_t>(64, 100);
+    test_compress_blocked<std::uint8_t>(100000, 100000);
+    test_compress_blocked<char>(1000, 999);
+    test_compress_blocked<int>(100000, 100001);
+
+    test_compress_packed();
+
     return 0;
 }
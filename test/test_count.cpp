@@ -1,5 +1,6 @@
 
 #include <itertools/count.hpp>
+#include <itertools/zip.hpp>
 
 #include <iostream>
 #include <vector>
@@ -13,9 +14,24 @@ void test_count()
     }
 }
 
+void test_count_zip()
+{
+    // the end of count() is unreachable; zip stops at the end of the vector
+    std::vector<char> letters{'a', 'b', 'c'};
+    for (auto [i, c] : itertools::zip(itertools::count(0, 1), letters))
+    {
+        std::cout << i << " " << c << std::endl;
+    }
+
+    auto view = itertools::count(10, 5);
+    std::cout << (view.begin() != view.end()) << " " << sizeof(view) << " " << sizeof(view.begin()) << std::endl;
+}
+
 int main()
 {
     test_count();
 
+    test_count_zip();
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <itertools/filter.hpp>
 
 #include <iostream>
+#include <list>
 #include <vector>
 
 void test_filter()
@@ -14,9 +15,58 @@ void test_filter()
     std::cout << std::endl;
 }
 
+void test_filter_blocked(std::size_t n)
+{
+    std::vector<int> nums(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        nums[i] = static_cast<int>(i * 7919 % 1000);
+    }
+    std::list<int> l(nums.begin(), nums.end());
+    auto pred = [](int x) { return x < 10; };
+
+    // vector goes through the blocked iterator, list through the plain one
+    std::vector<int> blocked, plain;
+    for (auto n : itertools::filter_blocked(pred, nums))
+    {
+        blocked.push_back(n);
+    }
+    for (auto n : itertools::filter_blocked(pred, l))
+    {
+        plain.push_back(n);
+    }
+    long long sum = 0;
+    for (auto n : blocked)
+    {
+        sum += n;
+    }
+    std::cout << n << ": " << blocked.size() << " " << sum << " " << (blocked == plain) << std::endl;
+}
+
+void test_filter_lazy()
+{
+    // filter() only calls the predicate on the elements it reads; filter_blocked() reads a block ahead
+    std::vector<int> nums(100, 1);
+    int calls = 0;
+    auto pred = [&calls](int) { ++calls; return true; };
+    *itertools::filter(pred, nums).begin();
+    std::cout << "filter calls: " << calls << std::endl; // filter calls: 1
+    calls = 0;
+    *itertools::filter_blocked(pred, nums).begin();
+    std::cout << "filter_blocked calls: " << calls << std::endl; // filter_blocked calls: 64
+}
+
 int main()
 {
     test_filter();
 
+    test_filter_blocked(0);
+    test_filter_blocked(63);
+    test_filter_blocked(64);
+    test_filter_blocked(65);
+    test_filter_blocked(100000);
+
+    test_filter_lazy();
+
     return 0;
 }
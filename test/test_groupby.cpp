@@ -1,8 +1,12 @@
 
 #include <itertools/groupby.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 void test_groupby(std::vector<int> &&nums)
@@ -19,6 +23,111 @@ void test_groupby(std::vector<int> &&nums)
     }
 }
 
+struct counted
+{
+    static inline int copies = 0;
+
+    counted(std::string s) : name(std::move(s)) {}
+
+    counted(const counted &other) : name(other.name) { ++copies; }
+
+    bool operator==(const counted &other) const { return name == other.name; }
+
+    std::string name;
+};
+
+void test_groupby_by_reference()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::tuple<counted, int>> rows;
+    for (auto name : {"apple", "apple", "fig", "pear", "pear", "pear"})
+    {
+        rows.emplace_back(counted(name), 1);
+    }
+    counted::copies = 0;
+    for (auto [k, g] : itertools::groupby(rows, [](auto &row) -> const counted & { return std::get<0>(row); }))
+    {
+        std::cout << k.name << " : " << std::distance(g.begin(), g.end()) << std::endl;
+    }
+    std::cout << "key copies: " << counted::copies << std::endl; // key copies: 0
+}
+
+void test_groupby_by_value()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    // the key is computed, so the group holds a copy that outlives the groupby
+    std::vector<int> nums{1, 1, 2};
+    auto [k, g] = *itertools::groupby(nums, [](int x) { return x * 10; }).begin();
+    static_assert(std::is_same_v<decltype(k), int>);
+    std::cout << k << " : " << g.size() << std::endl; // 10 : 2
+}
+
+void test_groupby_sorted()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums;
+    for (int k = 1; k <= 4; ++k)
+    {
+        nums.insert(nums.end(), 1000 * k, k);
+    }
+    int calls = 0;
+    auto key = [&calls](int x) { ++calls; return x; };
+    for (auto [k, g] : itertools::groupby(nums, key, itertools::assume_sorted))
+    {
+        std::cout << k << " : " << std::distance(g.begin(), g.end()) << std::endl;
+    }
+    std::cout << "key calls below 100: " << (calls < 100) << std::endl; // key calls below 100: 1
+
+    calls = 0;
+    for (auto [k, g] : itertools::groupby(nums, key))
+    {
+        std::cout << k << " : " << std::distance(g.begin(), g.end()) << std::endl;
+    }
+    std::cout << "key calls: " << calls << std::endl; // key calls: 10000
+}
+
+void test_groupby_parallel()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    // runs of every length from 1 to 1999, and one run across all the chunks
+    std::vector<int> nums;
+    for (int k = 1; k < 2000; ++k)
+    {
+        nums.insert(nums.end(), k, k);
+    }
+    nums.insert(nums.end(), 1000000, 2000);
+
+    itertools::parallel::thread_pool pool(4);
+    auto groups = itertools::groupby(nums, [](int x) { return x; }, itertools::assume_sorted, itertools::parallel::par.on(pool));
+    bool same = groups.size() == 2000;
+    int k = 1;
+    for (auto [key, g] : itertools::groupby(nums))
+    {
+        auto &[pkey, pg] = groups[k - 1];
+        same = same && key == pkey && g.begin() == pg.begin() && g.end() == pg.end();
+        ++k;
+    }
+    std::cout << groups.size() << " groups, same as sequential: " << same
+              << ", last: " << std::get<0>(groups.back()) << " x " << std::get<1>(groups.back()).size() << std::endl;
+    // 2000 groups, same as sequential: 1, last: 2000 x 1000000
+
+    std::atomic<long> checks{0};
+    itertools::for_each_group(
+        nums, [](const int &x) -> const int & { return x; },
+        [&checks](const int &key, auto g) {
+            if (g.size() == static_cast<std::size_t>(key) || key == 2000)
+            {
+                ++checks;
+            }
+        },
+        itertools::assume_sorted, itertools::parallel::par.on(pool));
+    std::cout << "groups checked: " << checks << std::endl; // groups checked: 2000
+}
+
 int main()
 {
     test_groupby({});
@@ -27,5 +136,13 @@ int main()
     test_groupby({1, 2, 2, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 5});
     test_groupby({1, 2, 2, 3, 3, 3, 2, 2, 1});
 
+    test_groupby_by_reference();
+
+    test_groupby_by_value();
+
+    test_groupby_sorted();
+
+    test_groupby_parallel();
+
     return 0;
 }
@@ -0,0 +1,82 @@
+#include <itertools/groupby_hash.hpp>
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+void test_groupby_hash()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums{1, 2, 1, 3, 2, 1};
+    for (auto &[k, sum] : itertools::groupby_hash(nums, [](int x) { return x; }, 0, std::plus<>()))
+    {
+        std::cout << k << " : " << sum << std::endl;
+    }
+    // 1 : 3
+    // 2 : 4
+    // 3 : 3
+}
+
+void test_groupby_hash_strings()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::tuple<std::string, double>> rows{{"apple", 1.5}, {"pear", 2}, {"apple", 0.5}, {"fig", 4}, {"pear", 1}};
+    auto totals = itertools::groupby_hash(
+        rows, [](auto &row) -> const std::string & { return std::get<0>(row); }, 0.0,
+        [](double acc, auto &row) { return acc + std::get<1>(row); });
+    std::cout << totals.size() << " groups, pear: " << totals.find("pear")->second
+              << ", kiwi found: " << (totals.find("kiwi") != totals.end()) << std::endl; // 3 groups, pear: 3, kiwi found: 0
+
+    // the keys cannot be changed under the table, only the aggregates
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(totals.begin()->first)>>);
+    totals.begin()->second *= 2;
+    std::cout << "apple: " << totals.find("apple")->second << std::endl; // apple: 4
+}
+
+void test_groupby_hash_parallel()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(1000000);
+    for (std::size_t i = 0; i < nums.size(); ++i)
+    {
+        nums[i] = static_cast<int>(i * 2654435761u % 1000);
+    }
+    auto key = [](int x) { return x % 100; };
+    auto seq = itertools::groupby_hash(nums, key, 0L, std::plus<>());
+
+    itertools::parallel::thread_pool pool(4);
+    auto par = itertools::groupby_hash(nums, key, 0L, std::plus<>(), std::plus<>(), itertools::parallel::par.on(pool));
+    bool same = seq.size() == par.size();
+    for (std::size_t i = 0; same && i < seq.size(); ++i)
+    {
+        same = *(seq.begin() + i) == *(par.begin() + i);
+    }
+    std::cout << seq.size() << " groups, same as sequential: " << same << std::endl; // 100 groups, same as sequential: 1
+
+    // counts per key, merged by adding the counts
+    auto counts = itertools::groupby_hash(
+        nums, key, 0, [](int n, int) { return n + 1; }, std::plus<>(), itertools::parallel::par.on(pool));
+    std::cout << "count of 7: " << counts.find(7)->second << std::endl; // count of 7: 10000
+
+    // init is not an identity of merge: it is counted once, not once per chunk
+    auto from_ten = itertools::groupby_hash(
+        nums, key, 10, [](int n, int) { return n + 1; }, std::plus<>(), itertools::parallel::par.on(pool));
+    std::cout << "count of 7 from 10: " << from_ten.find(7)->second << std::endl; // count of 7 from 10: 10010
+}
+
+int main()
+{
+    test_groupby_hash();
+
+    test_groupby_hash_strings();
+
+    test_groupby_hash_parallel();
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+
+#include <itertools/indirect_view.hpp>
+
+#include <iostream>
+#include <list>
+#include <vector>
+
+void test_indirect_view()
+{
+    std::list<int> nums{1, 2, 3, 4, 5};
+    std::vector<std::list<int>::iterator> selected{nums.begin(), std::prev(nums.end())};
+
+    itertools::indirect_view<std::list<int>::iterator> view(selected.data(), selected.size());
+    for (auto n : view)
+    {
+        std::cout << n << " ";
+    }
+    std::cout << std::endl;
+
+    // writes go through to the elements
+    view[1] = 50;
+    std::cout << nums.back() << std::endl;
+}
+
+int main()
+{
+    test_indirect_view();
+
+    return 0;
+}
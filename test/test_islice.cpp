@@ -1,9 +1,14 @@
 
+#include <itertools/count.hpp>
 #include <itertools/islice.hpp>
 
+#include <forward_list>
 #include <iostream>
 #include <list>
+#include <numeric>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 template <typename Items>
 void test_islice(Items &&items, int start, int stop, int step)
@@ -15,6 +20,61 @@ void test_islice(Items &&items, int start, int stop, int step)
     std::cout << std::endl;
 }
 
+void test_islice_negative()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    test_islice(std::string{"ABCDEFG"}, -3, 7, 1);   // "EFG"
+    test_islice(std::string{"ABCDEFG"}, 0, -2, 2);   // "ACE"
+    test_islice(std::string{"ABCDEFG"}, -1, -8, -2); // "GECA"
+    test_islice(std::string{"ABCDEFG"}, 6, 0, -3);   // "GD"
+    test_islice(std::string{"ABCDEFG"}, 100, -100, -1); // "GFEDCBA"
+    test_islice(std::string{"ABCDEFG"}, 2, 5, -1);   // ""
+    test_islice(std::list<char>{'a', 'b', 'c', 'd', 'e'}, -1, -6, -2); // "eca"
+    test_islice(std::list<char>{'a', 'b', 'c', 'd', 'e'}, -2, 5, 1);   // "de"
+
+    try
+    {
+        test_islice(std::forward_list<char>{'a', 'b'}, 1, 0, -1);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << e.what() << std::endl; // islice() step is negative, but the iterable is not bidirectional
+    }
+}
+
+void test_islice_random_access()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    // would take 10^12 increments without jumps
+    std::vector<long> nums(1000000);
+    std::iota(nums.begin(), nums.end(), 0L);
+    long sum = 0;
+    for (auto x : itertools::islice(nums, 999, 1000000, 1000))
+    {
+        sum += x;
+    }
+    std::cout << sum << std::endl; // 500499000
+
+    sum = 0;
+    for (auto x : itertools::islice(nums, -1, -1000001, -250000))
+    {
+        sum += x;
+    }
+    std::cout << sum << std::endl; // 2499996
+}
+
+void test_islice_endless()
+{
+    // count() ends with a sentinel, which islice wraps
+    for (auto n : itertools::islice(itertools::count(0, 3), 2, 12, 4))
+    {
+        std::cout << n << " ";
+    }
+    std::cout << std::endl;
+}
+
 int main()
 {
     test_islice(std::list<char>{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'}, 1, 16, 2);
@@ -26,6 +86,14 @@ int main()
     test_islice(std::string{"ABCDEFG"}, 0, 7, 7);  // "A"
     test_islice(std::string{"ABCDEFG"}, 7, 14, 1); // ""
     test_islice(std::string{""}, 0, 7, 1);         // ""
+    test_islice(std::string{"ABCDEFG"}, 0, 3, 1);  // "ABC"
+    test_islice(std::string{"ABCDEFG"}, 2, 6, 3);  // "CF"
+
+    test_islice_negative();
+
+    test_islice_random_access();
+
+    test_islice_endless();
 
     return 0;
 }
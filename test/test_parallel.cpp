@@ -0,0 +1,119 @@
+
+#include <itertools/combinations.hpp>
+#include <itertools/parallel.hpp>
+#include <itertools/product.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+void test_parallel_for_each()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> X(30), Y(40), Z(50);
+    std::iota(X.begin(), X.end(), 0);
+    std::iota(Y.begin(), Y.end(), 0);
+    std::iota(Z.begin(), Z.end(), 0);
+
+    std::atomic<long long> sum{0};
+    itertools::parallel::for_each(itertools::product(X, Y, Z), [&sum](auto &&xyz) {
+        auto [x, y, z] = xyz;
+        sum += x * y + z;
+    });
+
+    long long expected = 0;
+    for (auto [x, y, z] : itertools::product(X, Y, Z))
+    {
+        expected += x * y + z;
+    }
+    std::cout << sum << " " << expected << std::endl;
+}
+
+void test_parallel_reduce()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(100);
+    std::iota(nums.begin(), nums.end(), 0);
+
+    itertools::parallel::thread_pool pool(4);
+    auto count = itertools::parallel::transform_reduce(
+        pool, itertools::combinations<3>(nums), 0LL, [](long long a, long long b) { return a + b; },
+        [](auto &&abc) { auto [a, b, c] = abc; return (a + b + c) % 7 == 0 ? 1LL : 0LL; });
+
+    long long expected = 0;
+    for (auto [a, b, c] : itertools::combinations<3>(nums))
+    {
+        expected += (a + b + c) % 7 == 0 ? 1 : 0;
+    }
+    std::cout << count << " " << expected << std::endl;
+
+    std::cout << itertools::parallel::reduce(pool, nums, 0, [](int a, int b) { return a + b; }) << std::endl; // 4950
+}
+
+void test_parallel_find_first()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(60);
+    std::iota(nums.begin(), nums.end(), 0);
+
+    auto view = itertools::combinations<4>(nums);
+    auto it = itertools::parallel::find_first(view, [](auto &&abcd) {
+        auto [a, b, c, d] = abcd;
+        return a + b + c + d == 100 && a > 10;
+    });
+    auto [a, b, c, d] = *it;
+    std::cout << "index " << (it - view.begin()) << ": " << a << " " << b << " " << c << " " << d << std::endl; // 11 12 18 59
+
+    auto none = itertools::parallel::find_first(view, [](auto &&) { return false; });
+    std::cout << (none == view.end()) << std::endl;
+}
+
+void test_parallel_exception()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums(1000);
+    try
+    {
+        itertools::parallel::for_each(nums, [](int) { throw std::runtime_error("thrown from a worker"); });
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+}
+
+void test_parallel_nested()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    // workers that wait for the inner loops while other workers run their chunks
+    itertools::parallel::thread_pool pool(2);
+    std::vector<int> rows(8), cols(1000);
+    std::iota(cols.begin(), cols.end(), 0);
+    std::atomic<long long> sum{0};
+    itertools::parallel::for_each(pool, rows, [&](int) {
+        itertools::parallel::for_each(pool, cols, [&sum](int x) { sum += x; });
+    });
+    std::cout << sum << std::endl; // 3996000
+}
+
+int main()
+{
+    test_parallel_for_each();
+
+    test_parallel_reduce();
+
+    test_parallel_find_first();
+
+    test_parallel_exception();
+
+    test_parallel_nested();
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <itertools/permutations.hpp>
 
 #include <iostream>
+#include <list>
 #include <vector>
 
 void test_permutations()
@@ -23,9 +24,81 @@ void test_permutations()
     }
 }
 
+void test_permutations_list()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::list<char> letters{'A', 'B', 'C'};
+
+    std::cout << "3 arrange 3: " << std::endl;
+    for (auto &&[a, b, c] : itertools::permutations<3>(letters))
+    {
+        std::cout << a << b << c << std::endl;
+    }
+
+    std::cout << "3 arrange 4: " << std::endl;
+    for (auto &&[a, b, c, d] : itertools::permutations<4>(letters))
+    {
+        // shouldn't enter at all
+        std::cout << a << b << c << d << std::endl;
+    }
+}
+
+void test_permutations_count()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+    std::size_t count = 0;
+    for (auto &&[a, b, c, d, e, f] : itertools::permutations<6>(nums))
+    {
+        (void)a, (void)b, (void)c, (void)d, (void)e, (void)f;
+        ++count;
+    }
+    std::cout << "12 arrange 6: " << count << std::endl; // 665280
+}
+
+void test_permutations_runtime_r()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::list<char> letters{'A', 'B', 'C', 'D'};
+
+    for (std::size_t r : {0, 2, 5})
+    {
+        std::cout << "4 arrange " << r << ": " << std::endl;
+        for (auto &&p : itertools::permutations(letters, r))
+        {
+            for (auto c : p)
+            {
+                std::cout << c;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << "4 arrange 4: " << std::endl;
+    for (auto &&p : itertools::permutations(letters))
+    {
+        for (auto c : p)
+        {
+            std::cout << c;
+        }
+        std::cout << " ";
+    }
+    std::cout << std::endl;
+}
+
 int main()
 {
     test_permutations();
 
+    test_permutations_list();
+
+    test_permutations_count();
+
+    test_permutations_runtime_r();
+
     return 0;
 }
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -14,15 +15,13 @@ void test_product_iterator()
     char Y[2] = {'A', 'B'};
     double Z[2] = {0.5, 0.6};
 
-    // construct from most inner
-    itertools::product_iterator<double *> it_z_begin(begin(Z), end(Z));
-    itertools::product_iterator<double *> it_z_end(end(Z), end(Z));
+    // construct from the current, first and last iterator of each dimension
+    auto firsts = make_tuple(begin(X), begin(Y), begin(Z));
+    auto lasts = make_tuple(end(X), end(Y), end(Z));
+    auto ends = make_tuple(end(X), begin(Y), begin(Z));
 
-    itertools::product_iterator<char *, double *> it_yz_begin(begin(Y), end(Y), it_z_begin, it_z_begin, it_z_end);
-    itertools::product_iterator<char *, double *> it_yz_end(end(Y), end(Y), it_z_end, it_z_begin, it_z_end);
-
-    itertools::product_iterator<int *, char *, double *> it_xyz_begin(begin(X), end(X), it_yz_begin, it_yz_begin, it_yz_end);
-    itertools::product_iterator<int *, char *, double *> it_xyz_end(end(X), end(X), it_yz_end, it_yz_begin, it_yz_end);
+    itertools::product_iterator<int *, char *, double *> it_xyz_begin(firsts, firsts, lasts);
+    itertools::product_iterator<int *, char *, double *> it_xyz_end(ends, firsts, lasts);
 
     for (auto [x, y, z] : itertools::range_view(it_xyz_begin, it_xyz_end))
     {
@@ -42,11 +41,88 @@ void test_product()
     }
 }
 
+void test_product_random_access()
+{
+    std::vector<int> X = {1, 2, 3};
+    std::vector<char> Y = {'A', 'B'};
+    std::vector<double> Z = {0.5, 100.0};
+
+    auto p = itertools::product(X, Y, Z);
+    cout << "size: " << p.size() << endl;
+
+    // seeking must agree with stepping
+    auto it = p.begin();
+    for (std::ptrdiff_t k = 0; k != static_cast<std::ptrdiff_t>(p.size()); ++k, ++it)
+    {
+        if (p.begin() + k != it || it - p.begin() != k || p.begin()[k] != *it)
+        {
+            cout << "mismatch at " << k << endl;
+        }
+    }
+    cout << "end - begin: " << (p.end() - p.begin()) << endl;
+
+    // shard into 4 slices
+    std::size_t shards = 4;
+    for (std::size_t s = 0; s != shards; ++s)
+    {
+        auto first = p.begin() + p.size() * s / shards;
+        auto last = p.begin() + p.size() * (s + 1) / shards;
+        cout << "shard " << s << ":";
+        for (; first != last; ++first)
+        {
+            auto [x, y, z] = *first;
+            cout << " (" << x << " " << y << " " << z << ")";
+        }
+        cout << endl;
+    }
+}
+
+void test_product_empty()
+{
+    std::vector<int> X = {1, 2, 3};
+    std::vector<char> Y;
+
+    for (auto [x, y] : itertools::product(X, Y))
+    {
+        // shouldn't enter at all
+        cout << x << " " << y << endl;
+    }
+
+    // seeking in an empty product lands on its end
+    auto p = itertools::product(X, Y);
+    cout << "size: " << p.size() << endl; // size: 0
+    cout << "begin + 0 == end: " << (p.begin() + 0 == p.end()) << endl; // begin + 0 == end: 1
+    cout << "end - begin: " << (p.end() - p.begin()) << endl; // end - begin: 0
+    auto q = itertools::product(Y, X);
+    cout << "begin + 0 == end: " << (q.begin() + 0 == q.end()) << endl; // begin + 0 == end: 1
+}
+
+void test_product_references()
+{
+    std::vector<int> rows{1, 2};
+    std::vector<std::string> cols{"x", "y", "z"};
+    for (auto [row, col] : itertools::product(rows, cols))
+    {
+        col += std::to_string(row);
+    }
+    for (auto &col : cols)
+    {
+        std::cout << col << " ";
+    }
+    std::cout << std::endl; // x12 y12 z12
+}
+
 int main()
 {
     test_product_iterator();
 
     test_product();
 
+    test_product_random_access();
+
+    test_product_empty();
+
+    test_product_references();
+
     return 0;
 }
@@ -0,0 +1,162 @@
+#include <itertools/itertools.hpp>
+
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <vector>
+
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
+template <typename Iterable>
+using iterator_t = decltype(std::begin(std::declval<Iterable &>()));
+
+template <typename Iterable>
+using category_t = typename std::iterator_traits<iterator_t<Iterable>>::iterator_category;
+
+void test_iterator_traits()
+{
+    using vec = std::vector<int>;
+    using lst = std::list<int>;
+    auto add = [](int x, int y) { return x + y; };
+    auto odd = [](int x) { return x % 2 == 1; };
+
+    static_assert(std::is_same_v<category_t<decltype(itertools::zip(std::declval<vec &>(), std::declval<vec &>()))>, std::random_access_iterator_tag>);
+    static_assert(std::is_same_v<category_t<decltype(itertools::zip(std::declval<vec &>(), std::declval<lst &>()))>, std::forward_iterator_tag>);
+    static_assert(std::is_same_v<category_t<decltype(itertools::product(std::declval<vec &>(), std::declval<vec &>()))>, std::random_access_iterator_tag>);
+    static_assert(std::is_same_v<category_t<decltype(itertools::starmap(add, itertools::zip(std::declval<vec &>(), std::declval<vec &>())))>, std::random_access_iterator_tag>);
+    static_assert(std::is_same_v<category_t<decltype(itertools::filter(odd, std::declval<vec &>()))>, std::forward_iterator_tag>);
+    static_assert(std::is_same_v<category_t<decltype(itertools::chain(std::declval<vec &>(), std::declval<vec &>()))>, std::forward_iterator_tag>);
+
+    using zip_it = iterator_t<decltype(itertools::zip(std::declval<vec &>(), std::declval<vec &>()))>;
+    static_assert(std::is_same_v<std::iterator_traits<zip_it>::value_type, std::tuple<int, int>>);
+    static_assert(std::is_same_v<std::iterator_traits<zip_it>::reference, itertools::zip_reference<int &, int &>>);
+    static_assert(std::is_default_constructible_v<zip_it>);
+}
+
+void test_std_algorithms()
+{
+    std::vector<int> xs{1, 2, 3, 4, 5, 6, 7};
+    std::list<int> ys{10, 20, 30};
+
+    auto z = itertools::zip(xs, xs);
+    std::cout << std::distance(z.begin(), z.end()) << std::endl;
+
+    auto odd = itertools::filter([](int x) { return x % 2 == 1; }, xs);
+    std::vector<int> odds(odd.begin(), odd.end());
+    for (auto x : odds)
+    {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl;
+
+    auto c = itertools::chain(xs, ys);
+    std::cout << std::distance(c.begin(), c.end()) << std::endl;
+
+    auto s = itertools::islice(xs, 1, 6, 2);
+    std::vector<int> sliced(s.begin(), s.end());
+    for (auto x : sliced)
+    {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl;
+
+    auto p = itertools::product(xs, ys);
+    auto it = p.begin();
+    it++;
+    std::cout << std::get<1>(*it) << std::endl;
+
+    auto q = itertools::product(xs, xs);
+    std::cout << std::distance(q.begin(), q.end()) << std::endl;
+}
+
+#if defined(__cpp_lib_ranges)
+void test_views()
+{
+    std::vector<int> xs{1, 2, 3, 4, 5, 6, 7};
+    std::list<int> ys{10, 20, 30};
+    auto add = [](int x, int y) { return x + y; };
+
+    using vec = std::vector<int>;
+    using zip_view = decltype(itertools::zip(std::declval<vec &>(), std::declval<vec &>()));
+    using starmap_view = decltype(itertools::starmap(add, itertools::zip(std::declval<vec &>(), std::declval<vec &>())));
+    using product_view = decltype(itertools::product(std::declval<vec &>(), std::declval<vec &>()));
+    using chain_view = decltype(itertools::chain(std::declval<vec &>(), std::declval<vec &>()));
+    using groupby_view = decltype(itertools::groupby(std::declval<vec &>(), [](int x) { return x / 3; }));
+
+    static_assert(std::ranges::view<zip_view>);
+    static_assert(std::ranges::random_access_range<zip_view>);
+    static_assert(std::ranges::view<starmap_view>);
+    static_assert(std::ranges::random_access_range<starmap_view>);
+    static_assert(std::ranges::view<product_view>);
+    static_assert(std::ranges::random_access_range<product_view>);
+    static_assert(std::ranges::view<chain_view>);
+    static_assert(std::ranges::forward_range<chain_view>);
+    static_assert(std::ranges::view<groupby_view>);
+    static_assert(std::ranges::forward_range<groupby_view>);
+
+    // views that end with a sentinel
+    using count_view = decltype(itertools::count(0, 1));
+    using takewhile_view = decltype(itertools::takewhile([](int x) { return x < 5; }, std::declval<vec &>()));
+    static_assert(std::ranges::view<count_view>);
+    static_assert(std::ranges::forward_range<count_view>);
+    static_assert(std::ranges::view<takewhile_view>);
+    static_assert(std::ranges::forward_range<takewhile_view>);
+
+    for (auto x : itertools::chain(xs, ys) | std::views::filter([](int x) { return x % 2 == 0; }) | std::views::take(4))
+    {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl;
+
+    for (auto [x, y] : itertools::zip(xs, xs) | std::views::drop(5))
+    {
+        std::cout << x * y << " ";
+    }
+    std::cout << std::endl;
+
+    // over lists, the zip is forward only and knows no size, so take stops on the iterators
+    using list_zip_view = decltype(itertools::zip(std::declval<std::list<int> &>(), std::declval<std::list<int> &>()));
+    static_assert(std::ranges::forward_range<list_zip_view>);
+    static_assert(!std::ranges::sized_range<list_zip_view>);
+    static_assert(!std::sized_sentinel_for<std::ranges::iterator_t<list_zip_view>, std::ranges::iterator_t<list_zip_view>>);
+    using list_chain_view = decltype(itertools::chain_from_iterable(std::declval<std::list<std::list<int>> &>()));
+    static_assert(std::ranges::forward_range<list_chain_view>);
+    static_assert(!std::ranges::sized_range<list_chain_view>);
+    for (auto [x, y] : itertools::zip(ys, ys) | std::views::take(2))
+    {
+        std::cout << x + y << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << std::ranges::distance(itertools::product(ys, ys) | std::views::take(4)) << std::endl;
+    std::cout << std::ranges::distance(itertools::combinations<2>(ys) | std::views::take(2)) << std::endl;
+    for (auto [x, y] : itertools::combinations_with_replacement<2>(ys) | std::views::take(2))
+    {
+        std::cout << x + y << " ";
+    }
+    std::cout << std::endl;
+    std::cout << std::ranges::distance(itertools::combinations_with_replacement(ys, 2) | std::views::take(3)) << std::endl;
+
+    for (auto x : itertools::count(5, 5) | std::views::take(3))
+    {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << std::ranges::distance(itertools::starmap(add, itertools::zip(xs, xs))) << std::endl;
+}
+#endif
+
+int main()
+{
+    test_iterator_traits();
+
+    test_std_algorithms();
+
+#if defined(__cpp_lib_ranges)
+    test_views();
+#endif
+}
@@ -1,5 +1,6 @@
 
 #include <itertools/repeat.hpp>
+#include <itertools/zip.hpp>
 
 #include <iostream>
 #include <vector>
@@ -14,9 +15,39 @@ void test_repeat()
     }
 }
 
+struct copy_counter
+{
+    static inline int copies = 0;
+
+    copy_counter() = default;
+    copy_counter(const copy_counter &) { ++copies; }
+    copy_counter(copy_counter &&) = default;
+};
+
+void test_repeat_sentinel()
+{
+    // the value is moved into the view, and only copied by begin(): the end has no copy of it
+    auto view = itertools::repeat(copy_counter(), 3);
+    int n = 0;
+    for (auto &c : view)
+    {
+        (void)c;
+        ++n;
+    }
+    std::cout << n << " " << copy_counter::copies << std::endl;
+
+    std::vector<int> v{1, 2};
+    for (auto [x, y] : itertools::zip(v, itertools::repeat(7)))
+    {
+        std::cout << x << " " << y << std::endl;
+    }
+}
+
 int main()
 {
     test_repeat();
 
+    test_repeat_sentinel();
+
     return 0;
 }
@@ -0,0 +1,80 @@
+#include <itertools/chain.hpp>
+#include <itertools/segmented.hpp>
+
+#include <iostream>
+#include <list>
+#include <vector>
+
+void test_for_each_segment()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> a{1, 2, 3};
+    std::vector<int> b;
+    std::list<int> c{4, 5};
+    std::vector<int> d{6};
+    itertools::for_each_segment(itertools::chain(a, b, c, d), [](auto first, auto last) {
+        std::cout << "[ ";
+        for (; first != last; ++first)
+        {
+            std::cout << *first << " ";
+        }
+        std::cout << "]";
+    });
+    std::cout << std::endl; // [ 1 2 3 ][ ][ 4 5 ][ 6 ]
+
+    // a plain range is a single segment
+    itertools::for_each_segment(a, [](auto first, auto last) { std::cout << last - first << std::endl; }); // 3
+}
+
+void test_for_each_segment_partial()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> a{1, 2, 3};
+    std::vector<int> b{4, 5, 6};
+    std::vector<int> c{7, 8, 9};
+    auto chained = itertools::chain(a, b, c);
+    auto first = chained.begin();
+    ++first;
+    auto last = first;
+    for (int i = 0; i < 6; ++i)
+    {
+        ++last;
+    }
+    itertools::for_each_segment(first, last, [](auto first, auto last) {
+        std::cout << "[ ";
+        for (; first != last; ++first)
+        {
+            std::cout << *first << " ";
+        }
+        std::cout << "]";
+    });
+    std::cout << std::endl; // [ 2 3 ][ 4 5 6 ][ 7 ]
+}
+
+void test_for_each()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> a{1, 2, 3};
+    std::vector<int> b{4, 5};
+    std::vector<int> c{6};
+    long sum = 0;
+    itertools::for_each(itertools::chain(a, b, itertools::chain(c, a)), [&sum](int x) { sum += x; });
+    std::cout << sum << std::endl; // 27
+
+    itertools::for_each(itertools::chain(a, b), [](int &x) { x *= 10; });
+    std::cout << a[0] << " " << b[1] << std::endl; // 10 50
+}
+
+int main()
+{
+    test_for_each_segment();
+
+    test_for_each_segment_partial();
+
+    test_for_each();
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <itertools/accumulate.hpp>
+#include <itertools/chain.hpp>
+#include <itertools/compress.hpp>
+#include <itertools/islice.hpp>
+#include <itertools/parallel.hpp>
+#include <itertools/splittable.hpp>
+#include <itertools/starmap.hpp>
+#include <itertools/zip.hpp>
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+template <typename Chunks>
+void print_chunks(const Chunks &chunks)
+{
+    for (auto &chunk : chunks)
+    {
+        std::cout << "[";
+        for (auto &&x : chunk)
+        {
+            std::cout << x;
+        }
+        std::cout << "]";
+    }
+    std::cout << std::endl;
+}
+
+void test_split_zip()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::string s = "ABCDEFGHIJ";
+    std::list<int> l = {0, 1, 2, 3, 4, 5, 6};
+    auto view = itertools::zip(s, l);
+    std::cout << itertools::split_distance(view.begin(), view.end()) << std::endl; // 7
+
+    for (auto &chunk : itertools::chunk(view, 3))
+    {
+        std::cout << "[";
+        for (auto [c, i] : chunk)
+        {
+            std::cout << c << i;
+        }
+        std::cout << "]";
+    }
+    std::cout << std::endl; // [A0B1][C2D3][E4F5G6]
+}
+
+void test_split_chain()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::string a = "ABC", b = "", c = "DEFGH";
+    auto view = itertools::chain(a, b, c);
+    std::cout << itertools::split_distance(view.begin(), view.end()) << std::endl; // 8
+    print_chunks(itertools::chunk(view, 3));                                        // [AB][CDE][FGH]
+
+    auto [left, right] = itertools::split_at(view, 4);
+    print_chunks(std::vector{left, right}); // [ABCD][EFGH]
+}
+
+void test_split_islice()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::string s = "ABCDEFGHIJKLMNOP";
+    auto view = itertools::islice(s, 1, 14, 3);
+    std::cout << itertools::split_distance(view.begin(), view.end()) << std::endl; // 5
+    print_chunks(itertools::chunk(view, 2));                                        // [BE][HKN]
+}
+
+void test_split_compress()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::string s = "ABCDEFGH";
+    std::vector<int> selectors = {1, 0, 0, 1, 1, 0, 1, 1};
+    print_chunks(itertools::chunk(itertools::compress(s, selectors), 4)); // [A][D][E][GH]
+}
+
+void test_split_accumulate()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<int> nums = {1, 2, 3, 4, 5, 6};
+    for (auto &chunk : itertools::chunk(itertools::accumulate(nums, 0), 3))
+    {
+        std::cout << "[";
+        for (auto x : chunk)
+        {
+            std::cout << " " << x;
+        }
+        std::cout << " ]";
+    }
+    std::cout << std::endl; // [ 1 3 ][ 6 10 ][ 15 21 ]
+}
+
+void test_split_parallel()
+{
+    std::cout << __FUNCTION__ << std::endl;
+
+    std::vector<std::pair<int, int>> pairs;
+    std::list<int> l;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pairs.emplace_back(i, i);
+        l.push_back(i);
+    }
+    auto products = itertools::starmap([](int x, int y) { return x * y; }, pairs);
+    auto view = itertools::zip(products, l);
+    auto sum = itertools::parallel::transform_reduce(
+        view, 0LL, [](long long a, long long b) { return a + b; },
+        [](auto &&xy) { auto [x, y] = xy; return static_cast<long long>(x) + y; });
+    std::cout << sum << std::endl; // 332833500 + 499500
+}
+
+int main()
+{
+    test_split_zip();
+
+    test_split_chain();
+
+    test_split_islice();
+
+    test_split_compress();
+
+    test_split_accumulate();
+
+    test_split_parallel();
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <itertools/takewhile.hpp>
 
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 void test_takewhile()
@@ -14,9 +15,34 @@ void test_takewhile()
     std::cout << std::endl;
 }
 
+void test_takewhile_stops()
+{
+    std::vector<int> nums{1, 2, 3, 1, 2};
+    auto view = itertools::takewhile([](int n) { return n < 3; }, nums);
+
+    // the iterators are those of the vector; the predicate is in the end
+    static_assert(std::is_same_v<decltype(view.begin()), std::vector<int>::iterator>);
+
+    // stops at 3, and does not take the 1 and 2 after it
+    for (auto n : view)
+    {
+        std::cout << n << " ";
+    }
+    std::cout << std::endl;
+
+    std::vector<int> empty;
+    for (auto n : itertools::takewhile([](int n) { return n < 3; }, empty))
+    {
+        std::cout << n << " ";
+    }
+    std::cout << "empty" << std::endl;
+}
+
 int main()
 {
     test_takewhile();
 
+    test_takewhile_stops();
+
     return 0;
 }
@@ -1,8 +1,16 @@
-
+#include <itertools/starmap.hpp>
 #include <itertools/tee.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 void test_tee()
@@ -15,9 +23,257 @@ void test_tee()
     }
 }
 
+void test_tee_computes_once()
+{
+    std::vector<std::tuple<int, int>> pairs{{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+    int calls = 0;
+    auto products = itertools::starmap([&calls](int a, int b) { ++calls; return a * b; }, pairs);
+    auto [A, B, C] = itertools::tee<3>(products);
+
+    for (auto x : A)
+    {
+        std::cout << x << " ";
+    }
+    std::cout << "| buffered " << A.buffered() << " | ";
+    for (auto x : B)
+    {
+        std::cout << x << " ";
+    }
+    for (auto x : C)
+    {
+        std::cout << x << " ";
+    }
+    std::cout << "| calls " << calls << " buffered " << A.buffered() << std::endl; // 2 12 30 56 | buffered 4 | 2 12 30 56 2 12 30 56 | calls 4 buffered 0
+}
+
+void test_tee_lockstep()
+{
+    std::vector<int> nums(1000);
+    auto [X, Y] = itertools::tee<2>(nums);
+    std::size_t most = 0;
+    auto x = X.begin();
+    auto y = Y.begin();
+    for (; x != X.end() && y != Y.end(); ++x, ++y)
+    {
+        most = std::max(most, X.buffered());
+    }
+    std::cout << "most buffered " << most << std::endl; // 1
+}
+
+void test_tee_dropped()
+{
+    std::vector<int> nums(1000);
+    auto views = itertools::tee<2>(nums);
+    auto &kept = views[0];
+    {
+        auto dropped = std::move(views[1]);
+        auto d = dropped.begin();
+        ++d;
+        ++d;
+    }
+    std::size_t most = 0;
+    for (auto x = kept.begin(); x != kept.end(); ++x)
+    {
+        most = std::max(most, kept.buffered());
+    }
+    std::cout << "most buffered " << most << std::endl; // most buffered 2, the elements read by the dropped view
+}
+
+void test_tee_equality()
+{
+    std::vector<int> nums{1, 2, 3};
+    auto [X, Y] = itertools::tee<2>(nums);
+    auto x = X.begin();
+    auto y = Y.begin();
+    std::cout << (x == y) << (x == X.begin()) << (x == X.end()) << " ";
+    ++x;
+    std::cout << (x == y) << (x == X.begin()) << " ";
+    ++y;
+    std::cout << (x == y) << std::endl; // 110 01 1
+}
+
+void test_tee_input()
+{
+    std::istringstream in("one two three");
+    auto [words, again] = itertools::tee<2>(std::istream_iterator<std::string>(in), std::istream_iterator<std::string>());
+    auto w = words.begin();
+    std::cout << *w << " ";
+    ++w;
+    for (auto &word : again)
+    {
+        std::cout << word << " ";
+    }
+    for (; w != words.end(); ++w)
+    {
+        std::cout << *w << " ";
+    }
+    std::cout << std::endl; // one one two three two three
+}
+
+void test_concurrent_tee()
+{
+    std::vector<std::tuple<long, long>> pairs;
+    for (long i = 0; i < 100000; ++i)
+    {
+        pairs.emplace_back(i, i % 7);
+    }
+    std::atomic<int> calls{0};
+    auto products = itertools::starmap([&calls](long a, long b) { ++calls; return a * b; }, pairs);
+
+    auto views = itertools::concurrent_tee<3>(products, 64);
+    std::vector<long> sums(views.size());
+    std::vector<std::thread> consumers;
+    for (std::size_t k = 0; k < views.size(); ++k)
+    {
+        consumers.emplace_back([&sums, k](auto view) {
+            for (auto x : view)
+            {
+                sums[k] += x;
+            }
+        },
+                               std::move(views[k]));
+    }
+    for (auto &consumer : consumers)
+    {
+        consumer.join();
+    }
+    std::cout << sums[0] << " " << sums[1] << " " << sums[2] << " calls " << calls << std::endl; // 14999750005 three times, calls 100000
+
+    // a consumer that leaves early does not hold the others back
+    auto [early, full] = itertools::concurrent_tee<2>(products, 16);
+    std::thread leaver([](auto view) {
+        for (auto x : view)
+        {
+            if (x > 100)
+            {
+                break;
+            }
+        }
+    },
+                       std::move(early));
+    long count = 0;
+    for (auto x : full)
+    {
+        count += x >= 0;
+    }
+    leaver.join();
+    std::cout << count << std::endl; // 100000
+}
+
+void test_concurrent_tee_exception()
+{
+    std::vector<std::tuple<int>> ones(100, std::tuple<int>(1));
+    int calls = 0;
+    auto failing = itertools::starmap([&calls](int x) { if (++calls == 50) throw std::runtime_error("thrown by the producer"); return x; }, ones);
+    auto [view] = itertools::concurrent_tee<1>(failing, 8);
+    int count = 0;
+    try
+    {
+        for (auto x : view)
+        {
+            count += x;
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << count << " " << e.what() << std::endl; // 49 thrown by the producer
+    }
+}
+
+/// \brief Throws when moved for the third time, and counts the live objects.
+struct fragile
+{
+    static inline int moves = 0;
+    static inline int live = 0;
+    int value;
+
+    explicit fragile(int x) : value(x) { ++live; }
+
+    fragile(const fragile &other) : value(other.value) { ++live; }
+
+    fragile(fragile &&other) : value(other.value)
+    {
+        if (++moves == 3)
+        {
+            throw std::runtime_error("move thrown");
+        }
+        ++live;
+    }
+
+    ~fragile() { --live; }
+};
+
+void test_concurrent_tee_move_throws()
+{
+    // the ring holds 8 elements; the third one moved into a recycled slot throws
+    std::vector<std::tuple<int>> nums(20, std::tuple<int>(1));
+    auto fragiles = itertools::starmap([](int x) { return fragile(x); }, nums);
+    {
+        auto [view] = itertools::concurrent_tee<1>(fragiles, 8);
+        int count = 0;
+        try
+        {
+            for (auto &x : view)
+            {
+                count += x.value;
+            }
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cout << count << " " << e.what() << std::endl; // 10 move thrown
+        }
+    }
+    std::cout << "live: " << fragile::live << std::endl; // live: 0
+}
+
+void test_concurrent_tee_stalled()
+{
+    // the consumers sleep while the producer is slow, and the producer while a consumer is
+    std::vector<std::tuple<int>> nums(64, std::tuple<int>(1));
+    auto slow = itertools::starmap([](int x) { std::this_thread::sleep_for(std::chrono::microseconds(500)); return x; }, nums);
+    auto [a, b] = itertools::concurrent_tee<2>(slow, 4);
+    int sum_a = 0, sum_b = 0;
+    std::thread ta([&sum_a](auto view) {
+        for (int x : view)
+        {
+            sum_a += x;
+        }
+    },
+                   std::move(a));
+    std::thread tb([&sum_b](auto view) {
+        for (int x : view)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            sum_b += x;
+        }
+    },
+                   std::move(b));
+    ta.join();
+    tb.join();
+    std::cout << sum_a << " " << sum_b << std::endl; // 64 64
+}
+
 int main()
 {
     test_tee();
 
+    test_tee_computes_once();
+
+    test_tee_lockstep();
+
+    test_tee_dropped();
+
+    test_tee_equality();
+
+    test_tee_input();
+
+    test_concurrent_tee();
+
+    test_concurrent_tee_exception();
+
+    test_concurrent_tee_move_throws();
+
+    test_concurrent_tee_stalled();
+
     return 0;
 }
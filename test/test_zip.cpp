@@ -1,7 +1,9 @@
 
 #include <itertools/zip.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <vector>
 #include <list>
 #include <string>
@@ -17,9 +19,121 @@ void test_zip()
     }
 }
 
+struct copy_counter
+{
+    static inline int copies = 0;
+
+    copy_counter() = default;
+    copy_counter(const copy_counter &) { ++copies; }
+};
+
+void test_zip_references()
+{
+    std::vector<std::string> names{"a", "b", "c"};
+    std::vector<copy_counter> counters(3);
+    std::vector<int> scores{1, 2, 3};
+
+    for (auto [name, counter, score] : itertools::zip(names, counters, scores))
+    {
+        name += "!";
+        score *= 10;
+    }
+    for (auto [name, score] : itertools::zip(names, scores))
+    {
+        std::cout << name << " " << score << std::endl;
+    }
+    std::cout << "copies " << copy_counter::copies << std::endl; // 0
+}
+
+void test_zip_random_access()
+{
+    std::vector<int> keys{1, 3, 5, 7, 9, 11};
+    std::vector<std::string> values{"a", "b", "c", "d", "e"};
+    auto view = itertools::zip(keys, values);
+    std::cout << view.size() << std::endl; // 5
+
+    auto it = std::lower_bound(view.begin(), view.end(), 6, [](auto &&kv, int key) { return std::get<0>(kv) < key; });
+    auto [key, value] = *it;
+    std::cout << (it - view.begin()) << " " << key << " " << value << std::endl; // 3 7 d
+
+    auto [last_key, last_value] = view.begin()[view.size() - 1];
+    std::cout << last_key << " " << last_value << " " << (view.end() - 1 > view.begin()) << std::endl; // 9 e 1
+}
+
+void test_zip_sort()
+{
+    std::vector<int> ids{5, 3, 9, 1, 3};
+    std::vector<std::string> names{"e", "c", "i", "a", "c2"};
+    auto rows = itertools::zip(ids, names);
+
+    std::sort(rows.begin(), rows.end());
+    for (auto [id, name] : rows)
+    {
+        std::cout << id << name << " ";
+    }
+    std::cout << std::endl; // 1a 3c 3c2 5e 9i
+
+    std::stable_sort(rows.begin(), rows.end(), [](auto &&a, auto &&b) { return std::get<1>(a).size() > std::get<1>(b).size(); });
+    for (auto [id, name] : rows)
+    {
+        std::cout << id << name << " ";
+    }
+    std::cout << std::endl; // 3c2 1a 3c 5e 9i
+
+    auto first = rows.begin();
+    swap(first[0], first[4]);
+    first[1] = std::tuple<int, std::string>(0, "z");
+    for (auto [id, name] : rows)
+    {
+        std::cout << id << name << " ";
+    }
+    std::cout << std::endl; // 9i 0z 3c 5e 3c2
+}
+
+void test_apply_permutation()
+{
+    std::vector<int> ids{10, 20, 30, 40, 50};
+    std::vector<std::string> names{"a", "b", "c", "d", "e"};
+    std::vector<std::size_t> perm{3, 1, 4, 0, 2};
+    itertools::apply_permutation(itertools::zip(ids, names), perm);
+    for (auto [id, name] : itertools::zip(ids, names))
+    {
+        std::cout << id << name << " ";
+    }
+    std::cout << std::endl; // 40d 20b 50e 10a 30c
+
+    // sort a permutation by a key, then move every column once
+    std::vector<std::size_t> order(ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&ids](std::size_t a, std::size_t b) { return ids[a] < ids[b]; });
+    itertools::apply_permutation(itertools::zip(ids, names), order);
+    for (auto [id, name] : itertools::zip(ids, names))
+    {
+        std::cout << id << name << " ";
+    }
+    std::cout << std::endl; // 10a 20b 30c 40d 50e
+
+    try
+    {
+        itertools::apply_permutation(ids, std::vector<int>{0, 1, 2, 3, 3});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+}
+
 int main()
 {
     test_zip();
 
+    test_zip_references();
+
+    test_zip_random_access();
+
+    test_zip_sort();
+
+    test_apply_permutation();
+
     return 0;
 }